@@ -129,35 +129,51 @@ namespace nlohmann
         using const_reverse_iterator = typename internal_map_type::const_reverse_iterator;
 
     public:
-        /// default constructor
+        /// default constructor, the key storage is only allocated on first insertion
         fifo_map()
             : m_keys()
-            , m_compare(&m_keys)
+            , m_compare(nullptr)
             , m_map(m_compare)
         {
         }
 
         /// copy constructor
         fifo_map(const fifo_map& f)
-            : m_keys(f.m_keys)
-            , m_compare(&m_keys, f.m_compare.m_timestamp)
+            : m_keys(f.m_keys ? std::make_unique<key_storage>(*f.m_keys) : nullptr)
+            , m_compare(m_keys.get(), f.m_compare.m_timestamp)
             , m_map(f.m_map.begin(), f.m_map.end(), m_compare)
         {
         }
 
+        /// move constructor, the key storage lives on the heap so the comparators
+        /// moved along with the internal map keep pointing to a valid storage
+        fifo_map(fifo_map&& f) noexcept
+            : m_keys(std::move(f.m_keys))
+            , m_compare(f.m_compare)
+            , m_map(std::move(f.m_map))
+        {
+            f.m_compare = Compare(nullptr);
+        }
+
         void operator=(const fifo_map& f)
         {
-            m_keys = std::unordered_map<Key, size_t>(f.m_keys);
-            m_compare = Compare(&m_keys, f.m_compare.m_timestamp);
+            m_keys = f.m_keys ? std::make_unique<key_storage>(*f.m_keys) : nullptr;
+            m_compare = Compare(m_keys.get(), f.m_compare.m_timestamp);
             m_map = internal_map_type(f.m_map.begin(), f.m_map.end(), m_compare);
         }
 
+        void operator=(fifo_map&& f) noexcept
+        {
+            m_map = std::move(f.m_map);
+            m_keys = std::move(f.m_keys);
+            m_compare = f.m_compare;
+            f.m_compare = Compare(nullptr);
+        }
+
         /// constructor for a range of elements
         template <class InputIterator>
         fifo_map(InputIterator first, InputIterator last)
-            : m_keys()
-            , m_compare(&m_keys)
-            , m_map(m_compare)
+            : fifo_map()
         {
             for (auto it = first; it != last; ++it)
             {
@@ -194,15 +210,15 @@ namespace nlohmann
         /// access specified element
         T& operator[](const Key& key)
         {
-            m_compare.add_key(key);
+            add_key(key);
             return m_map[key];
         }
 
         /// access specified element
         T& operator[](Key&& key)
         {
-            m_compare.add_key(key);
-            return m_map[key];
+            add_key(key);
+            return m_map[std::move(key)];
         }
 
         /*
@@ -303,6 +319,14 @@ namespace nlohmann
             return m_map.max_size();
         }
 
+        /// reserves storage for the insertion order of at least count keys,
+        /// the internal node-based map has no notion of capacity
+        void reserve(size_type count)
+        {
+            ensure_keys();
+            m_keys->reserve(count);
+        }
+
         /*
      * Modifiers
      */
@@ -311,35 +335,38 @@ namespace nlohmann
         void clear() noexcept
         {
             m_map.clear();
-            m_keys.clear();
+            if (m_keys)
+            {
+                m_keys->clear();
+            }
         }
 
         /// insert value
         std::pair<iterator, bool> insert(const value_type& value)
         {
-            m_compare.add_key(value.first);
+            add_key(value.first);
             return m_map.insert(value);
         }
 
         /// insert value
         template <class P> std::pair<iterator, bool> insert(P&& value)
         {
-            m_compare.add_key(value.first);
-            return m_map.insert(value);
+            add_key(value.first);
+            return m_map.insert(std::forward<P>(value));
         }
 
         /// insert value with hint
         iterator insert(const_iterator hint, const value_type& value)
         {
-            m_compare.add_key(value.first);
+            add_key(value.first);
             return m_map.insert(hint, value);
         }
 
         /// insert value with hint
         iterator insert(const_iterator hint, value_type&& value)
         {
-            m_compare.add_key(value.first);
-            return m_map.insert(hint, value);
+            add_key(value.first);
+            return m_map.insert(hint, std::move(value));
         }
 
         /// insert value range
@@ -347,7 +374,7 @@ namespace nlohmann
         {
             for (const_iterator it = first; it != last; ++it)
             {
-                m_compare.add_key(it->first);
+                add_key(it->first);
             }
 
             m_map.insert(first, last);
@@ -358,7 +385,7 @@ namespace nlohmann
         {
             for (auto value : ilist)
             {
-                m_compare.add_key(value.first);
+                add_key(value.first);
             }
 
             m_map.insert(ilist);
@@ -368,16 +395,25 @@ namespace nlohmann
         template <class... Args> std::pair<iterator, bool> emplace(Args&&... args)
         {
             typename fifo_map::value_type value(std::forward<Args>(args)...);
-            m_compare.add_key(value.first);
+            add_key(value.first);
             return m_map.emplace(std::move(value));
         }
 
+        /// constructs element in-place if the key does not exist yet, the key is
+        /// only copied to the insertion order storage
+        template <class... Args>
+        std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args)
+        {
+            add_key(key);
+            return m_map.try_emplace(std::move(key), std::forward<Args>(args)...);
+        }
+
         /// constructs element in-place with hint
         template <class... Args>
         iterator emplace_hint(const_iterator hint, Args&&... args)
         {
             typename fifo_map::value_type value(std::forward<Args>(args)...);
-            m_compare.add_key(value.first);
+            add_key(value.first);
             return m_map.emplace_hint(hint, std::move(value));
         }
 
@@ -415,7 +451,7 @@ namespace nlohmann
         /// swaps the contents
         void swap(fifo_map& other)
         {
-            std::swap(m_map, other.m_map);
+            m_map.swap(other.m_map);
             std::swap(m_compare, other.m_compare);
             std::swap(m_keys, other.m_keys);
         }
@@ -523,8 +559,28 @@ namespace nlohmann
         }
 
     private:
+        using key_storage = std::unordered_map<Key, std::size_t>;
+
+        /// lazily allocates the key storage, maps without keys do not
+        /// compare anything so their internal map can be safely rebuilt
+        void ensure_keys()
+        {
+            if (!m_keys)
+            {
+                m_keys = std::make_unique<key_storage>();
+                m_compare = Compare(m_keys.get(), m_compare.m_timestamp);
+                m_map = internal_map_type(m_compare);
+            }
+        }
+
+        void add_key(const Key& key)
+        {
+            ensure_keys();
+            m_compare.add_key(key);
+        }
+
         /// the keys
-        std::unordered_map<Key, std::size_t> m_keys;
+        std::unique_ptr<key_storage> m_keys;
         /// the comparison object
         Compare m_compare;
         /// the internal data structure
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <vili/node.hpp>
+
+/**
+ * \brief Compact binary encoding of vili nodes
+ *
+ * Layout : magic, format version, key dictionary, root node.
+ * Each node starts with a type tag, integers are zigzag varints, strings and keys
+ * are length-prefixed, object keys are indexes in the dictionary and arrays of
+ * integers are packed (a single tag for the whole array).
+ */
+namespace vili::binary
+{
+    constexpr std::string_view magic = "VILB";
+    constexpr std::uint8_t version = 1;
+
+    enum class tag : std::uint8_t
+    {
+        null,
+        boolean_false,
+        boolean_true,
+        integer,
+        number,
+        string,
+        array,
+        object,
+        integer_array
+    };
+
+    /**
+     * \brief Returns true if data starts with the binary vili magic
+     */
+    bool is_binary(std::string_view data);
+
+    std::string dump(const vili::node& data);
+    vili::node load(std::string_view data);
+    vili::node from_file(std::string_view path);
+}
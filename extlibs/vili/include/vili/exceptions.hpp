@@ -235,4 +235,14 @@ namespace vili::exceptions
             this->error("Could not dump number value : [{}]", value);
         }
     };
+
+    class invalid_binary_data : public exception<invalid_binary_data>
+    {
+    public:
+        invalid_binary_data(std::string_view reason, debug_info info)
+            : exception("invalid_binary_data", info)
+        {
+            this->error("Could not decode binary vili content : {}", reason);
+        }
+    };
 }
\ No newline at end of file
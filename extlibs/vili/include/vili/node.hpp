@@ -74,6 +74,10 @@ namespace vili
          * \brief Creates a node that contains a string
          */
         node(const string& value);
+        /**
+         * \brief Creates a node that contains a string, taking ownership of its buffer
+         */
+        node(string&& value);
         /**
          * \brief Creates a node that contains a string
          */
@@ -90,10 +94,18 @@ namespace vili
          * \brief Creates a node that contains an array (vector-like container)
          */
         node(const array& value);
+        /**
+         * \brief Creates a node that contains an array by moving the given one
+         */
+        node(array&& value);
         /**
          * \brief Creates a node that contains a object (map-like container)
          */
         node(const object& value);
+        /**
+         * \brief Creates a node that contains an object by moving the given one
+         */
+        node(object&& value);
         /**
          * \brief node copy constructor
          */
@@ -106,6 +118,10 @@ namespace vili
          * \brief node affectation operator
          */
         void operator=(const node& copy);
+        /**
+         * \brief node move affectation operator
+         */
+        void operator=(node&& move) noexcept;
 
         /**
          * \brief Retrieves the type of the underlying value of the node
@@ -291,6 +307,17 @@ namespace vili
         const node& operator[](size_t index) const;
 
         void push(const node& value);
+        /**
+         * \brief Pushes a child node at the end of an array without copying it
+         * \param value Value of the node to push
+         */
+        void push(node&& value);
+        /**
+         * \brief Reserves room for at least size children
+         *        (array capacity or object insertion order storage)
+         * \param size Amount of children to reserve room for
+         */
+        void reserve(size_t size);
         /**
          * \brief Emplace a child node at given index
          * \tparam value_type Any type castable to a vili::node
@@ -402,7 +429,7 @@ namespace vili
         if (is<array>())
         {
             auto& vector = std::get<array>(m_data);
-            vector.emplace(vector.cbegin() + index, std::forward(value));
+            vector.emplace(vector.cbegin() + index, std::forward<value_type>(value));
         }
         else
         {
@@ -434,5 +461,49 @@ namespace vili
             typeid(T).name(), to_string(type()), VILI_EXC_INFO);
     }
 
+    namespace detail
+    {
+        inline void emplace_items(object&)
+        {
+        }
+
+        template <class key_type, class value_type, class... items_types>
+        void emplace_items(
+            object& map, key_type&& key, value_type&& value, items_types&&... items)
+        {
+            map.emplace(std::forward<key_type>(key), node(std::forward<value_type>(value)));
+            emplace_items(map, std::forward<items_types>(items)...);
+        }
+    }
+
+    /**
+     * \brief Builds an array node in one step, the array is sized once
+     *        and every value is moved in place
+     * \param items Values (castable to vili::node) of the array
+     * \return node containing the array
+     */
+    template <class... items_types> node make_array(items_types&&... items)
+    {
+        array vector;
+        vector.reserve(sizeof...(items));
+        (vector.emplace_back(std::forward<items_types>(items)), ...);
+        return node(std::move(vector));
+    }
+
+    /**
+     * \brief Builds an object node in one step, the object is sized once
+     *        and every value is moved in place
+     * \param items Alternating keys and values : make_object("x", 1, "y", 2)
+     * \return node containing the object
+     */
+    template <class... items_types> node make_object(items_types&&... items)
+    {
+        static_assert(sizeof...(items) % 2 == 0, "make_object expects key / value pairs");
+        object map;
+        map.reserve(sizeof...(items) / 2);
+        detail::emplace_items(map, std::forward<items_types>(items)...);
+        return node(std::move(map));
+    }
+
     std::ostream& operator<<(std::ostream& os, const node& elem);
 }
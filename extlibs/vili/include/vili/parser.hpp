@@ -1,10 +1,58 @@
 #pragma once
 
+#include <span>
+
 #include <vili/node.hpp>
+#include <vili/parser/event_state.hpp>
+#include <vili/parser/lazy_document.hpp>
 #include <vili/parser/parser_state.hpp>
 
 namespace vili::parser
 {
+    /**
+     * \brief How from_file reads the content of a file
+     */
+    enum class file_input_mode
+    {
+        /**
+         * \brief The file is mapped in memory and parsed in place, no copy is made
+         *        (falls back to buffered on platforms without memory-mapped files)
+         */
+        mapped,
+        /**
+         * \brief The whole file is read into a buffer owned by the parser
+         */
+        buffered
+    };
+
+    struct options
+    {
+        file_input_mode file_input = file_input_mode::mapped;
+        /**
+         * \brief Amount of threads used to parse the root sections of a document,
+         *        0 uses one thread per core (small documents are parsed on one thread)
+         */
+        std::size_t threads = 1;
+    };
+
     vili::node from_string(std::string_view data, state parser_state = state {});
-    vili::node from_file(std::string_view path);
-}
\ No newline at end of file
+    vili::node from_string(std::string_view data, const options& parser_options);
+    /**
+     * \brief Parses a caller-owned buffer in place, the buffer must outlive the call
+     */
+    vili::node parse(std::span<const char> buffer, state parser_state = state {});
+    vili::node from_file(std::string_view path, const options& parser_options = options {});
+    /**
+     * \brief Parses data into an existing state, a document can be fed
+     *        in several consecutive pieces (each one starting on a new line)
+     */
+    void parse_into(std::string_view data, state& parser_state);
+
+    /**
+     * \brief Parses a vili document and reports its content to handler
+     *        without building any node tree
+     */
+    void visit_string(std::string_view data, event_handler& handler);
+    void visit_file(std::string_view path, event_handler& handler,
+        const options& parser_options = options {});
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vili/parser/grammar.hpp>
+#include <vili/parser/event_state.hpp>
 #include <vili/parser/parser_state.hpp>
 
 namespace vili::parser
@@ -11,24 +12,26 @@ namespace vili::parser
 
     template <> struct action<rules::string_content>
     {
-        template <class ParseInput> static void apply(const ParseInput& in, state& state)
+        template <class ParseInput, class state_type>
+        static void apply(const ParseInput& in, state_type& state)
         {
-            state.push(in.string());
+            state.push(vili::string(in.string_view()));
         }
     };
 
     template <> struct action<rules::number>
     {
-        template <class ParseInput> static void apply(const ParseInput& in, state& state)
+        template <class ParseInput, class state_type>
+        static void apply(const ParseInput& in, state_type& state)
         {
-            const std::string_view data_in = in.string_view();
             state.push(utils::string::to_double(in.string_view()));
         }
     };
 
     template <> struct action<rules::integer>
     {
-        template <class ParseInput> static void apply(const ParseInput& in, state& state)
+        template <class ParseInput, class state_type>
+        static void apply(const ParseInput& in, state_type& state)
         {
             state.push(utils::string::to_long(in.string_view()));
         }
@@ -36,23 +39,26 @@ namespace vili::parser
 
     template <> struct action<rules::boolean>
     {
-        template <class ParseInput> static void apply(const ParseInput& in, state& state)
+        template <class ParseInput, class state_type>
+        static void apply(const ParseInput& in, state_type& state)
         {
-            state.push((in.string_view() == "true" ? true : false));
+            state.push(in.string_view() == "true");
         }
     };
 
     template <> struct action<rules::identifier>
     {
-        template <class ParseInput> static void apply(const ParseInput& in, state& state)
+        template <class ParseInput, class state_type>
+        static void apply(const ParseInput& in, state_type& state)
         {
-            state.set_active_identifier(std::move(in.string()));
+            state.set_active_identifier(in.string_view());
         }
     };
 
     template <> struct action<rules::open_array>
     {
-        template <class ParseInput> static void apply(const ParseInput& in, state& state)
+        template <class ParseInput, class state_type>
+        static void apply(const ParseInput& in, state_type& state)
         {
             state.push(vili::array {});
             state.open_block();
@@ -61,7 +67,8 @@ namespace vili::parser
 
     template <> struct action<rules::close_array>
     {
-        template <class ParseInput> static void apply(const ParseInput& in, state& state)
+        template <class ParseInput, class state_type>
+        static void apply(const ParseInput& in, state_type& state)
         {
             state.close_block();
         }
@@ -69,7 +76,8 @@ namespace vili::parser
 
     template <> struct action<rules::open_object>
     {
-        template <class ParseInput> static void apply(const ParseInput& in, state& state)
+        template <class ParseInput, class state_type>
+        static void apply(const ParseInput& in, state_type& state)
         {
             state.push(vili::object {});
             state.open_block();
@@ -78,7 +86,8 @@ namespace vili::parser
 
     template <> struct action<rules::close_object>
     {
-        template <class ParseInput> static void apply(const ParseInput& in, state& state)
+        template <class ParseInput, class state_type>
+        static void apply(const ParseInput& in, state_type& state)
         {
             state.close_block();
         }
@@ -86,7 +95,8 @@ namespace vili::parser
 
     template <> struct action<rules::indent_based_object>
     {
-        template <class ParseInput> static void apply(const ParseInput& in, state& state)
+        template <class ParseInput, class state_type>
+        static void apply(const ParseInput& in, state_type& state)
         {
             state.push(vili::object {});
             state.open_block();
@@ -96,7 +106,8 @@ namespace vili::parser
 
     template <> struct action<rules::indent>
     {
-        template <class ParseInput> static void apply(const ParseInput& in, state& state)
+        template <class ParseInput, class state_type>
+        static void apply(const ParseInput& in, state_type& state)
         {
             try
             {
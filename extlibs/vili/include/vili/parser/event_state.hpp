@@ -0,0 +1,98 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+#include <vili/node.hpp>
+#include <vili/parser/indentation.hpp>
+
+namespace vili::parser
+{
+    /**
+     * \brief Value returned by event_handler callbacks to drive the parser
+     */
+    enum class event_result
+    {
+        /**
+         * \brief Keeps reporting events
+         */
+        proceed,
+        /**
+         * \brief Skips the upcoming value (on_key) or the content of the container
+         *        (on_begin_object / on_begin_array), no event is reported for it,
+         *        including its on_end
+         */
+        skip,
+        /**
+         * \brief Stops parsing immediately
+         */
+        stop
+    };
+
+    /**
+     * \brief Receives the content of a vili document as a stream of events
+     *        instead of a node tree, override only the callbacks you need
+     */
+    class event_handler
+    {
+    public:
+        virtual ~event_handler() = default;
+        /**
+         * \brief Called for each key of an object, before its value
+         */
+        virtual event_result on_key(std::string_view key);
+        virtual event_result on_begin_object();
+        virtual event_result on_begin_array();
+        /**
+         * \brief Called for each boolean, integer, number or string value
+         */
+        virtual event_result on_scalar(const node& value);
+        /**
+         * \brief Called when the last opened (and not skipped) container is closed
+         */
+        virtual event_result on_end();
+    };
+
+    /**
+     * \brief Parser state that forwards the document structure to an
+     *        event_handler, nothing is kept once an event has been reported
+     */
+    class event_state
+    {
+    private:
+        struct frame
+        {
+            int indent;
+            bool silent;
+            bool report_end;
+        };
+
+        event_handler& m_handler;
+        std::vector<frame> m_stack;
+        indentation m_indentation;
+        bool m_skip_value = false;
+        frame m_last_container { 0, false, false };
+
+        void dispatch(event_result result);
+
+    public:
+        /**
+         * \brief Thrown (and caught by the parser) when a handler returns stop
+         */
+        struct stop_parsing
+        {
+        };
+
+        explicit event_state(event_handler& handler);
+        void set_indent(int64_t indent);
+        void use_indent();
+        void set_active_identifier(std::string_view identifier);
+        void open_block();
+        void close_block();
+        void push(node&& data);
+        /**
+         * \brief Closes the blocks still opened at the end of the document
+         */
+        void finish();
+    };
+}
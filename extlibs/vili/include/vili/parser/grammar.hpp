@@ -1,10 +1,117 @@
 #pragma once
 
+#include <cstdint>
+#include <cstring>
+
 #include <tao/pegtl.hpp>
 
 namespace vili::parser::rules
 {
     namespace peg = tao::pegtl;
+
+    namespace scan
+    {
+        constexpr std::uint64_t ones = ~std::uint64_t(0) / 255;
+        constexpr std::uint64_t high_bits = ones * 0x80;
+
+        /**
+         * \brief Checks 8 bytes at once for any byte that can not be part of
+         *        a plain ASCII string run (control, non-ASCII or backslash)
+         */
+        inline bool has_special_byte(std::uint64_t word)
+        {
+            const std::uint64_t control = (word - ones * 0x20) & ~word;
+            const std::uint64_t backslash = word ^ (ones * '\\');
+            const std::uint64_t escape = (backslash - ones) & ~backslash;
+            return ((control | escape | word) & high_bits) != 0;
+        }
+
+        inline bool is_plain_ascii(unsigned char c)
+        {
+            return c >= 0x20 && c < 0x80 && c != '\\';
+        }
+
+        /**
+         * \brief Returns the end of the run of plain ASCII characters
+         *        (no escape, no closing quote) starting at begin
+         */
+        inline const char* plain_ascii_run(const char* begin, const char* end)
+        {
+            if (const void* delimiter = std::memchr(begin, '"', end - begin))
+            {
+                end = static_cast<const char*>(delimiter);
+            }
+            const char* it = begin;
+            std::uint64_t word;
+            while (end - it >= 8)
+            {
+                std::memcpy(&word, it, 8);
+                if (has_special_byte(word))
+                {
+                    break;
+                }
+                it += 8;
+            }
+            while (it != end && is_plain_ascii(static_cast<unsigned char>(*it)))
+            {
+                ++it;
+            }
+            return it;
+        }
+
+        inline const char* digit_run(const char* begin, const char* end)
+        {
+            const char* it = begin;
+            while (it != end && static_cast<unsigned char>(*it - '0') < 10)
+            {
+                ++it;
+            }
+            return it;
+        }
+
+        inline const char* space_run(const char* begin, const char* end)
+        {
+            const char* it = begin;
+            while (it != end
+                && (*it == ' ' || *it == '\t' || *it == '\n' || *it == '\r'
+                    || *it == '\v' || *it == '\f'))
+            {
+                ++it;
+            }
+            return it;
+        }
+    }
+
+    /**
+     * \brief Matches the longest (non-empty) run of characters accepted by scanner
+     *        in a single step instead of one rule invocation per character
+     */
+    template <const char* (*scanner)(const char*, const char*), bool multiline = false>
+    struct run
+    {
+        using rule_t = run;
+        using subs_t = peg::empty_list;
+
+        template <class ParseInput> static bool match(ParseInput& in)
+        {
+            const char* begin = in.current();
+            const char* end = scanner(begin, in.end());
+            if (end == begin)
+            {
+                return false;
+            }
+            if constexpr (multiline)
+            {
+                in.bump(end - begin);
+            }
+            else
+            {
+                in.bump_in_this_line(end - begin);
+            }
+            return true;
+        }
+    };
+
     // clang-format off
     struct identifier : peg::identifier {};
     struct indent : peg::seq<peg::bol, peg::star<peg::blank>> {};
@@ -17,7 +124,8 @@ namespace vili::parser::rules
     struct unicode : peg::list<peg::seq<peg::one<'u'>, peg::rep<4, peg::must< xdigit>>>, peg::one<'\\'>> {};
     struct escaped_char : peg::one< '"', '\\', '/', 'b', 'f', 'n', 'r', 't'> {};
     struct escaped : peg::sor<escaped_char, unicode> {};
-    struct unescaped : peg::utf8::range< 0x20, 0x10FFFF> {};
+    struct ascii_run : run<scan::plain_ascii_run> {};
+    struct unescaped : peg::sor<ascii_run, peg::utf8::range< 0x20, 0x10FFFF>> {};
     struct char_ : peg::if_then_else<peg::one<'\\'>, peg::must<escaped>, unescaped> {};
 
     struct string_content : peg::until<peg::at<string_delimiter>, peg::must<char_>> {};
@@ -32,18 +140,18 @@ namespace vili::parser::rules
     struct boolean : peg::sor<true_, false_> {};
 
     // Numbers
-    struct digits : peg::plus<peg::digit> {};
+    struct digits : run<scan::digit_run> {};
     struct sign : peg::one<'-'> {};
-    struct integer : peg::seq<peg::opt<sign>, digits> {};
     struct floating_point : peg::one<'.'> {};
-    struct number : peg::seq<peg::opt<sign>, peg::star<peg::digit>, peg::one<'.'>, digits> {};
+    struct integer : peg::seq<peg::opt<sign>, digits, peg::not_at<floating_point>> {};
+    struct number : peg::seq<peg::opt<sign>, peg::opt<digits>, floating_point, digits> {};
 
-    // Data
-    struct data : peg::sor<boolean, number, integer, string> {};
+    // Data (integers first as they are the most common values and scanned only once)
+    struct data : peg::sor<boolean, integer, number, string> {};
     struct brace_based_object;
     struct array;
     struct object;
-    struct inline_element : peg::sor<boolean, number, integer, string, array, brace_based_object> {};
+    struct inline_element : peg::sor<boolean, integer, number, string, array, brace_based_object> {};
     struct inline_node : peg::seq<affectation, inline_element> {};
     struct element : peg::sor<data, array, object> {};
 
@@ -51,7 +159,8 @@ namespace vili::parser::rules
     struct inline_comment : peg::seq<peg::star<peg::blank>, peg::one<'#'>, peg::until<peg::eolf>> {};
     struct multiline_comment : peg::seq<peg::string<'/', '*'>, peg::until<peg::string<'*', '/'>, peg::sor<multiline_comment, peg::any>>> {};
     struct comment : peg::sor<inline_comment, multiline_comment> {};
-    struct space_or_comment : peg::sor<comment, peg::space> {};
+    struct spaces : run<scan::space_run, true> {};
+    struct space_or_comment : peg::sor<spaces, comment> {};
     struct endline : peg::sor<inline_comment, peg::eol> {};
     struct multiline_comment_block : peg::seq<peg::plus<peg::pad<multiline_comment, peg::blank>>, peg::sor<endline, peg::eolf>> {};
 
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+
+namespace vili::parser
+{
+    /**
+     * \brief Indentation bookkeeping shared by the parser states, the states only
+     *        differ by how they store their blocks
+     */
+    class indentation
+    {
+    private:
+        int64_t m_base = -1;
+        int64_t m_current = 0;
+
+    public:
+        explicit indentation(int64_t base = -1);
+        /**
+         * \brief Checks the indentation of a new line against the indent of the
+         *        current block, throws on inconsistent or too much indentation
+         * \return amount of blocks closed by the line
+         */
+        [[nodiscard]] int64_t update(int64_t indent, int block_indent);
+        /**
+         * \brief Width of one indentation level (-1 until an indented line is parsed)
+         */
+        [[nodiscard]] int64_t base() const;
+        /**
+         * \brief Indent of the content of a block opened on the current line
+         */
+        [[nodiscard]] int block_indent() const;
+    };
+}
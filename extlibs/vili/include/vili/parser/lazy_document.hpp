@@ -0,0 +1,90 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <vili/node.hpp>
+
+namespace vili::parser
+{
+    struct options;
+
+    /**
+     * \brief Byte range of a key and its value in a vili document
+     */
+    struct section
+    {
+        std::string_view key;
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    /**
+     * \brief vili document that is only parsed when its nodes are accessed
+     *
+     * A first pass indexes the byte ranges of the root keys (keys starting at
+     * column 0), the content of a section is parsed the first time it is requested.
+     * Children of indentation-based root objects can also be parsed one by one.
+     * Keys must start their line (a key preceded by a comment on the same line
+     * is kept in the previous section).
+     */
+    class lazy_document
+    {
+    private:
+        struct root_section
+        {
+            std::string_view key;
+            std::vector<section> ranges;
+            bool children_indexed = false;
+            std::vector<section> children;
+        };
+
+        std::shared_ptr<const void> m_owner;
+        std::string_view m_data;
+        std::vector<std::string_view> m_keys;
+        std::unordered_map<std::string_view, root_section> m_sections;
+        std::unordered_map<std::string_view, node> m_nodes;
+        std::unordered_map<std::string_view, node> m_partial_nodes;
+
+        root_section& find_section(std::string_view key);
+        void index_children(root_section& root);
+
+    public:
+        /**
+         * \brief Indexes the root sections of data, owner keeps data alive
+         */
+        lazy_document(std::shared_ptr<const void> owner, std::string_view data);
+
+        /**
+         * \brief Root keys of the document, in order of appearance
+         */
+        [[nodiscard]] const std::vector<std::string_view>& keys() const;
+        [[nodiscard]] bool contains(std::string_view key) const;
+        /**
+         * \brief Parses (once) and returns the root node named key
+         */
+        const node& at(std::string_view key);
+        /**
+         * \brief Parses (once) and returns a child of an indentation-based root
+         *        object without parsing its siblings
+         */
+        const node& at(std::string_view key, std::string_view child);
+        /**
+         * \brief Parses every remaining section and returns the whole document,
+         *        already parsed nodes are moved out of the document
+         */
+        node to_node();
+    };
+
+    /**
+     * \brief Indexes the sections of data starting at column indent
+     *        that are not nested in an array, a brace-based object or a comment
+     */
+    std::vector<section> index_sections(std::string_view data, std::size_t indent = 0);
+
+    lazy_document lazy_from_string(std::string data);
+    lazy_document lazy_from_file(std::string_view path, const options& parser_options);
+}
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <stack>
+#include <string_view>
 
 #include <vili/node.hpp>
+#include <vili/parser/indentation.hpp>
 
 namespace vili::parser
 {
@@ -24,20 +26,30 @@ namespace vili::parser
     private:
         std::string m_identifier;
         std::stack<node_in_stack> m_stack;
-        int64_t m_indent_base = -1;
-        int64_t m_indent_current = 0;
+        indentation m_indentation;
         vili::node* m_last_container = nullptr;
 
     public:
         node root;
         state();
         state(const state& state);
-        state(state&& state);
+        state(state&& state) noexcept;
         void set_indent(int64_t indent);
+        /**
+         * \brief Width of one indentation level (-1 until an indented line is parsed)
+         */
+        [[nodiscard]] int64_t indent_base() const;
         void use_indent();
-        void set_active_identifier(std::string&& identifier);
+        /**
+         * \brief Sets the key of the next pushed node, copied once from the input
+         *        then moved into the object by push
+         */
+        void set_active_identifier(std::string_view identifier);
         void open_block();
         void close_block();
+        /**
+         * \brief Moves a node into the current container (no copy of its content)
+         */
         void push(node&& data);
     };
 }
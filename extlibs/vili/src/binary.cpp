@@ -0,0 +1,358 @@
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+#include <vili/binary.hpp>
+#include <vili/exceptions.hpp>
+
+#include <tao/pegtl.hpp>
+#if defined(_POSIX_MAPPED_FILES) || defined(_WIN32)
+#include <tao/pegtl/mmap_input.hpp>
+#define VILI_MMAP_AVAILABLE
+#endif
+
+namespace peg = tao::pegtl;
+
+namespace vili::binary
+{
+    namespace
+    {
+        /**
+         * \brief Deepest container nesting accepted by the decoder, read_node recurses
+         *        once per level
+         */
+        constexpr std::size_t max_depth = 512;
+
+        std::uint64_t zigzag_encode(vili::integer value)
+        {
+            return (static_cast<std::uint64_t>(value) << 1)
+                ^ static_cast<std::uint64_t>(value >> 63);
+        }
+
+        vili::integer zigzag_decode(std::uint64_t value)
+        {
+            return static_cast<vili::integer>(value >> 1)
+                ^ -static_cast<vili::integer>(value & 1);
+        }
+
+        class encoder
+        {
+        private:
+            std::unordered_map<std::string_view, std::uint64_t> m_key_ids;
+            std::vector<std::string_view> m_keys;
+            std::string m_body;
+
+            void collect_keys(const vili::node& data)
+            {
+                if (data.is<vili::object>())
+                {
+                    for (const auto& [key, value] : data.items())
+                    {
+                        if (m_key_ids.try_emplace(key, m_keys.size()).second)
+                        {
+                            m_keys.push_back(key);
+                        }
+                        collect_keys(value);
+                    }
+                }
+                else if (data.is<vili::array>())
+                {
+                    for (const vili::node& item : data)
+                    {
+                        collect_keys(item);
+                    }
+                }
+            }
+
+            static void write_varint(std::string& output, std::uint64_t value)
+            {
+                while (value >= 0x80)
+                {
+                    output.push_back(static_cast<char>((value & 0x7F) | 0x80));
+                    value >>= 7;
+                }
+                output.push_back(static_cast<char>(value));
+            }
+
+            static void write_string(std::string& output, std::string_view value)
+            {
+                write_varint(output, value.size());
+                output.append(value);
+            }
+
+            void write_tag(tag type)
+            {
+                m_body.push_back(static_cast<char>(type));
+            }
+
+            void write_node(const vili::node& data)
+            {
+                switch (data.type())
+                {
+                case node_type::null:
+                    write_tag(tag::null);
+                    break;
+                case node_type::boolean:
+                    write_tag(
+                        data.as<vili::boolean>() ? tag::boolean_true : tag::boolean_false);
+                    break;
+                case node_type::integer:
+                    write_tag(tag::integer);
+                    write_varint(m_body, zigzag_encode(data.as<vili::integer>()));
+                    break;
+                case node_type::number:
+                {
+                    write_tag(tag::number);
+                    std::uint64_t bits;
+                    const vili::number value = data.as<vili::number>();
+                    std::memcpy(&bits, &value, sizeof(bits));
+                    for (unsigned int byte = 0; byte < sizeof(bits); byte++)
+                    {
+                        m_body.push_back(static_cast<char>(bits >> (byte * 8)));
+                    }
+                    break;
+                }
+                case node_type::string:
+                    write_tag(tag::string);
+                    write_string(m_body, data.as<vili::string>());
+                    break;
+                case node_type::array:
+                {
+                    const vili::array& items = data.as<vili::array>();
+                    const bool packed = !items.empty()
+                        && std::all_of(items.begin(), items.end(),
+                            [](const vili::node& item) { return item.is<vili::integer>(); });
+                    write_tag(packed ? tag::integer_array : tag::array);
+                    write_varint(m_body, items.size());
+                    for (const vili::node& item : items)
+                    {
+                        if (packed)
+                        {
+                            write_varint(m_body, zigzag_encode(item.as<vili::integer>()));
+                        }
+                        else
+                        {
+                            write_node(item);
+                        }
+                    }
+                    break;
+                }
+                case node_type::object:
+                    write_tag(tag::object);
+                    write_varint(m_body, data.size());
+                    for (const auto& [key, value] : data.items())
+                    {
+                        write_varint(m_body, m_key_ids.at(key));
+                        write_node(value);
+                    }
+                    break;
+                }
+            }
+
+        public:
+            std::string encode(const vili::node& data)
+            {
+                collect_keys(data);
+                write_node(data);
+                std::string output(magic);
+                output.push_back(static_cast<char>(version));
+                write_varint(output, m_keys.size());
+                for (const std::string_view key : m_keys)
+                {
+                    write_string(output, key);
+                }
+                output.append(m_body);
+                return output;
+            }
+        };
+
+        class decoder
+        {
+        private:
+            std::string_view m_data;
+            std::size_t m_position = 0;
+            std::vector<std::string_view> m_keys;
+
+            void require(std::size_t size) const
+            {
+                if (m_data.size() - m_position < size)
+                {
+                    throw exceptions::invalid_binary_data(
+                        "unexpected end of data", VILI_EXC_INFO);
+                }
+            }
+
+            std::uint64_t read_varint()
+            {
+                std::uint64_t value = 0;
+                for (unsigned int shift = 0; shift < 64; shift += 7)
+                {
+                    require(1);
+                    const auto byte = static_cast<std::uint8_t>(m_data[m_position++]);
+                    value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+                    if (!(byte & 0x80))
+                    {
+                        return value;
+                    }
+                }
+                throw exceptions::invalid_binary_data("varint is too long", VILI_EXC_INFO);
+            }
+
+            std::size_t read_size()
+            {
+                const std::uint64_t size = read_varint();
+                // Every element takes at least one byte, bigger counts are corrupted
+                require(size);
+                return static_cast<std::size_t>(size);
+            }
+
+            std::string_view read_string()
+            {
+                const std::size_t size = read_size();
+                const std::string_view value = m_data.substr(m_position, size);
+                m_position += size;
+                return value;
+            }
+
+            vili::node read_node(std::size_t depth)
+            {
+                if (depth > max_depth)
+                {
+                    throw exceptions::invalid_binary_data("nesting too deep", VILI_EXC_INFO);
+                }
+                require(1);
+                const auto type = static_cast<tag>(m_data[m_position++]);
+                switch (type)
+                {
+                case tag::null:
+                    return vili::node {};
+                case tag::boolean_false:
+                    return false;
+                case tag::boolean_true:
+                    return true;
+                case tag::integer:
+                    return zigzag_decode(read_varint());
+                case tag::number:
+                {
+                    require(sizeof(std::uint64_t));
+                    std::uint64_t bits = 0;
+                    for (unsigned int byte = 0; byte < sizeof(bits); byte++)
+                    {
+                        bits |= static_cast<std::uint64_t>(
+                                    static_cast<std::uint8_t>(m_data[m_position++]))
+                            << (byte * 8);
+                    }
+                    vili::number value;
+                    std::memcpy(&value, &bits, sizeof(value));
+                    return value;
+                }
+                case tag::string:
+                    return vili::string(read_string());
+                case tag::array:
+                case tag::integer_array:
+                {
+                    const std::size_t size = read_size();
+                    vili::array items;
+                    items.reserve(size);
+                    for (std::size_t index = 0; index < size; index++)
+                    {
+                        if (type == tag::integer_array)
+                        {
+                            items.emplace_back(zigzag_decode(read_varint()));
+                        }
+                        else
+                        {
+                            items.push_back(read_node(depth + 1));
+                        }
+                    }
+                    return items;
+                }
+                case tag::object:
+                {
+                    const std::size_t size = read_size();
+                    vili::object items;
+                    items.reserve(size);
+                    for (std::size_t index = 0; index < size; index++)
+                    {
+                        const std::uint64_t key_id = read_varint();
+                        if (key_id >= m_keys.size())
+                        {
+                            throw exceptions::invalid_binary_data(
+                                "key index out of dictionary", VILI_EXC_INFO);
+                        }
+                        const std::string_view key = m_keys[key_id];
+                        // The encoder writes each key once per object
+                        if (!items.try_emplace(std::string(key), read_node(depth + 1)).second)
+                        {
+                            throw exceptions::invalid_binary_data(
+                                "duplicate object key", VILI_EXC_INFO);
+                        }
+                    }
+                    return items;
+                }
+                }
+                throw exceptions::invalid_binary_data("unknown node tag", VILI_EXC_INFO);
+            }
+
+        public:
+            explicit decoder(std::string_view data)
+                : m_data(data)
+            {
+            }
+
+            vili::node decode()
+            {
+                if (!is_binary(m_data))
+                {
+                    throw exceptions::invalid_binary_data("missing magic", VILI_EXC_INFO);
+                }
+                m_position = magic.size();
+                require(1);
+                if (static_cast<std::uint8_t>(m_data[m_position++]) != version)
+                {
+                    throw exceptions::invalid_binary_data(
+                        "unsupported format version", VILI_EXC_INFO);
+                }
+                const std::size_t key_count = read_size();
+                m_keys.reserve(key_count);
+                for (std::size_t index = 0; index < key_count; index++)
+                {
+                    m_keys.push_back(read_string());
+                }
+                return read_node(0);
+            }
+        };
+    }
+
+    bool is_binary(std::string_view data)
+    {
+        return data.substr(0, magic.size()) == magic;
+    }
+
+    std::string dump(const vili::node& data)
+    {
+        return encoder().encode(data);
+    }
+
+    vili::node load(std::string_view data)
+    {
+        return decoder(data).decode();
+    }
+
+    vili::node from_file(std::string_view path)
+    {
+        try
+        {
+#ifdef VILI_MMAP_AVAILABLE
+            peg::mmap_input in(path);
+#else
+            peg::read_input in(path);
+#endif
+            return load(std::string_view(in.begin(), in.size()));
+        }
+        catch (const std::system_error& e)
+        {
+            throw exceptions::file_not_found(path, VILI_EXC_INFO).nest(e);
+        }
+    }
+}
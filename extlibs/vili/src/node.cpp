@@ -211,6 +211,11 @@ namespace vili
         m_data = value;
     }
 
+    node::node(string&& value)
+    {
+        m_data = std::move(value);
+    }
+
     node::node(std::string_view value)
     {
         m_data = std::string(value);
@@ -231,11 +236,21 @@ namespace vili
         m_data = value;
     }
 
+    node::node(array&& value)
+    {
+        m_data = std::move(value);
+    }
+
     node::node(const object& value)
     {
         m_data = value;
     }
 
+    node::node(object&& value)
+    {
+        m_data = std::move(value);
+    }
+
     node::node(const node& copy)
     {
         m_data = copy.m_data;
@@ -251,6 +266,11 @@ namespace vili
         m_data = copy.m_data;
     }
 
+    void node::operator=(node&& move) noexcept
+    {
+        m_data = std::move(move.m_data);
+    }
+
     node_type node::type() const
     {
         if (is_null())
@@ -516,6 +536,36 @@ namespace vili
         }
     }
 
+    void node::push(node&& value)
+    {
+        if (is<array>())
+        {
+            std::get<array>(m_data).push_back(std::move(value));
+        }
+        else
+        {
+            throw exceptions::invalid_cast(
+                array_typename, to_string(type()), VILI_EXC_INFO);
+        }
+    }
+
+    void node::reserve(size_t size)
+    {
+        if (is<array>())
+        {
+            std::get<array>(m_data).reserve(size);
+        }
+        else if (is<object>())
+        {
+            std::get<object>(m_data).reserve(size);
+        }
+        else
+        {
+            throw exceptions::invalid_cast(
+                container_typename, to_string(type()), VILI_EXC_INFO);
+        }
+    }
+
     void node::insert(size_t index, const node& value)
     {
         if (is<array>())
@@ -1,21 +1,30 @@
 #include <vili/node.hpp>
+#include <vili/parser.hpp>
 #include <vili/parser/actions.hpp>
 #include <vili/parser/grammar.hpp>
 #include <vili/parser/grammar_errors.hpp>
 #include <vili/parser/parser_state.hpp>
 #include <vili/types.hpp>
 
+#include <algorithm>
+#include <exception>
 #include <fstream>
 #include <iostream>
+#include <thread>
 
 #include <tao/pegtl.hpp>
 #include <tao/pegtl/contrib/trace.hpp>
+#if defined(_POSIX_MAPPED_FILES) || defined(_WIN32)
+#include <tao/pegtl/mmap_input.hpp>
+#define VILI_MMAP_AVAILABLE
+#endif
 
 namespace peg = tao::pegtl;
 
 namespace vili::parser
 {
-    template <class input_type> vili::node parse(input_type&& input, state parser_state)
+    template <class input_type, class state_type>
+    void run(input_type&& input, state_type& parser_state)
     {
         try
         {
@@ -39,22 +48,173 @@ namespace vili::parser
         {
             std::cerr << "vili::exception : " << e.what() << std::endl;
         }*/
+    }
 
-        return parser_state.root;
+    template <class input_type> vili::node parse(input_type&& input, state& parser_state)
+    {
+        run(input, parser_state);
+        return std::move(parser_state.root);
+    }
+
+    template <class input_type>
+    void visit(input_type&& input, event_handler& handler)
+    {
+        event_state parser_state(handler);
+        try
+        {
+            run(input, parser_state);
+            parser_state.finish();
+        }
+        catch (const event_state::stop_parsing&)
+        {
+        }
+    }
+
+    /**
+     * \brief Documents are not split in chunks smaller than this (in bytes)
+     */
+    constexpr std::size_t min_parallel_chunk = 1 << 16;
+
+    /**
+     * \brief Parses data on several threads, each one parsing a range of root sections
+     *        with its own state, results are merged in document order
+     */
+    vili::node parse_parallel(
+        std::string_view data, const std::string& source, std::size_t threads)
+    {
+        if (threads == 0)
+        {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        // Chunks can only start on a root key line (column 0, outside of any
+        // container or comment) where the indentation stack is back to the root
+        const std::size_t chunk_size = std::max(data.size() / threads, min_parallel_chunk);
+        std::vector<std::size_t> bounds { 0 };
+        for (const section& root : index_sections(data))
+        {
+            if (root.begin - bounds.back() >= chunk_size)
+            {
+                bounds.push_back(root.begin);
+            }
+        }
+        bounds.push_back(data.size());
+
+        const std::size_t chunks = bounds.size() - 1;
+        std::vector<state> states(chunks);
+        std::vector<std::exception_ptr> errors(chunks);
+        const auto parse_chunk = [&](std::size_t chunk, std::size_t line)
+        {
+            try
+            {
+                // Lines are numbered from the document start, bytes from the chunk start
+                peg::memory_input in(data.data() + bounds[chunk],
+                    data.data() + bounds[chunk + 1], source, 0, line, 1);
+                run(in, states[chunk]);
+            }
+            catch (...)
+            {
+                errors[chunk] = std::current_exception();
+            }
+        };
+        std::vector<std::thread> workers;
+        workers.reserve(chunks - 1);
+        std::size_t line = 1;
+        for (std::size_t chunk = 1; chunk < chunks; chunk++)
+        {
+            line += std::count(
+                data.begin() + bounds[chunk - 1], data.begin() + bounds[chunk], '\n');
+            workers.emplace_back(parse_chunk, chunk, line);
+        }
+        parse_chunk(0, 1);
+        for (std::thread& worker : workers)
+        {
+            worker.join();
+        }
+        for (const std::exception_ptr& error : errors)
+        {
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+
+        // A sequential parse uses the first indentation width for the whole document
+        int64_t indent_base = -1;
+        for (const state& chunk_state : states)
+        {
+            if (indent_base == -1)
+            {
+                indent_base = chunk_state.indent_base();
+            }
+            else if (chunk_state.indent_base() != -1
+                && chunk_state.indent_base() != indent_base)
+            {
+                throw exceptions::inconsistent_indentation(
+                    chunk_state.indent_base(), indent_base, VILI_EXC_INFO);
+            }
+        }
+
+        vili::object& document = states.front().root.items();
+        for (std::size_t chunk = 1; chunk < chunks; chunk++)
+        {
+            for (auto& [key, value] : states[chunk].root.items())
+            {
+                auto [element, inserted]
+                    = document.try_emplace(std::string(key), std::move(value));
+                if (!inserted)
+                {
+                    // Root key redefined in a later chunk
+                    element->second.merge(value);
+                }
+            }
+        }
+        return std::move(states.front().root);
     }
 
     vili::node from_string(std::string_view data, state parser_state)
     {
-        peg::memory_input in(data.data(), "string_source");
+        peg::memory_input in(data.data(), data.data() + data.size(), "string_source");
+        return parse(in, parser_state);
+    }
+
+    vili::node from_string(std::string_view data, const options& parser_options)
+    {
+        if (parser_options.threads != 1)
+        {
+            return parse_parallel(data, "string_source", parser_options.threads);
+        }
+        return from_string(data);
+    }
+
+    vili::node parse(std::span<const char> buffer, state parser_state)
+    {
+        peg::memory_input in(buffer.data(), buffer.data() + buffer.size(), "buffer_source");
         return parse(in, parser_state);
     }
 
-    vili::node from_file(std::string_view path)
+    vili::node from_file(std::string_view path, const options& parser_options)
     {
         try
         {
             state parser_state;
-            peg::file_input in(path);
+#ifdef VILI_MMAP_AVAILABLE
+            if (parser_options.file_input == file_input_mode::mapped)
+            {
+                peg::mmap_input in(path);
+                if (parser_options.threads != 1)
+                {
+                    return parse_parallel(std::string_view(in.begin(), in.size()),
+                        in.source(), parser_options.threads);
+                }
+                return parse(in, parser_state);
+            }
+#endif
+            peg::read_input in(path);
+            if (parser_options.threads != 1)
+            {
+                return parse_parallel(std::string_view(in.begin(), in.size()), in.source(),
+                    parser_options.threads);
+            }
             return parse(in, parser_state);
         }
         catch (const std::system_error& e)
@@ -62,4 +222,37 @@ namespace vili::parser
             throw exceptions::file_not_found(path, VILI_EXC_INFO).nest(e);
         }
     }
-}
+
+    void parse_into(std::string_view data, state& parser_state)
+    {
+        peg::memory_input in(data.data(), data.data() + data.size(), "string_source");
+        run(in, parser_state);
+    }
+
+    void visit_string(std::string_view data, event_handler& handler)
+    {
+        peg::memory_input in(data.data(), data.data() + data.size(), "string_source");
+        visit(in, handler);
+    }
+
+    void visit_file(
+        std::string_view path, event_handler& handler, const options& parser_options)
+    {
+        try
+        {
+#ifdef VILI_MMAP_AVAILABLE
+            if (parser_options.file_input == file_input_mode::mapped)
+            {
+                peg::mmap_input in(path);
+                return visit(in, handler);
+            }
+#endif
+            peg::read_input in(path);
+            visit(in, handler);
+        }
+        catch (const std::system_error& e)
+        {
+            throw exceptions::file_not_found(path, VILI_EXC_INFO).nest(e);
+        }
+    }
+}
\ No newline at end of file
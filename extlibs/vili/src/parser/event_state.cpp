@@ -0,0 +1,114 @@
+#include <vili/parser/event_state.hpp>
+
+namespace vili::parser
+{
+    event_result event_handler::on_key(std::string_view)
+    {
+        return event_result::proceed;
+    }
+
+    event_result event_handler::on_begin_object()
+    {
+        return event_result::proceed;
+    }
+
+    event_result event_handler::on_begin_array()
+    {
+        return event_result::proceed;
+    }
+
+    event_result event_handler::on_scalar(const node&)
+    {
+        return event_result::proceed;
+    }
+
+    event_result event_handler::on_end()
+    {
+        return event_result::proceed;
+    }
+
+    event_state::event_state(event_handler& handler)
+        : m_handler(handler)
+    {
+        m_stack.push_back(frame { 0, false, false });
+    }
+
+    void event_state::dispatch(event_result result)
+    {
+        if (result == event_result::stop)
+        {
+            throw stop_parsing {};
+        }
+    }
+
+    void event_state::set_indent(int64_t indent)
+    {
+        const int64_t closed_blocks
+            = m_indentation.update(indent, m_stack.back().indent);
+        for (int64_t block = 0; block < closed_blocks; block++)
+        {
+            this->close_block();
+        }
+    }
+
+    void event_state::use_indent()
+    {
+        m_stack.back().indent = m_indentation.block_indent();
+    }
+
+    void event_state::set_active_identifier(std::string_view identifier)
+    {
+        if (m_stack.back().silent)
+        {
+            return;
+        }
+        const event_result result = m_handler.on_key(identifier);
+        dispatch(result);
+        m_skip_value = (result == event_result::skip);
+    }
+
+    void event_state::open_block()
+    {
+        m_stack.push_back(m_last_container);
+    }
+
+    void event_state::close_block()
+    {
+        const bool report_end = m_stack.back().report_end;
+        m_stack.pop_back();
+        if (report_end)
+        {
+            dispatch(m_handler.on_end());
+        }
+    }
+
+    void event_state::push(node&& data)
+    {
+        const bool silent = m_stack.back().silent || m_skip_value;
+        m_skip_value = false;
+        if (data.is_container())
+        {
+            bool skip_content = silent;
+            if (!silent)
+            {
+                const event_result result = data.is_array() ? m_handler.on_begin_array()
+                                                            : m_handler.on_begin_object();
+                dispatch(result);
+                skip_content = (result == event_result::skip);
+            }
+            m_last_container = frame { 0, skip_content, !skip_content };
+        }
+        else if (!silent)
+        {
+            dispatch(m_handler.on_scalar(data));
+        }
+    }
+
+    void event_state::finish()
+    {
+        while (m_stack.size() > 1)
+        {
+            this->close_block();
+        }
+    }
+}
@@ -0,0 +1,55 @@
+#include <vili/exceptions.hpp>
+#include <vili/parser/indentation.hpp>
+
+namespace vili::parser
+{
+    indentation::indentation(int64_t base)
+        : m_base(base)
+    {
+    }
+
+    int64_t indentation::update(int64_t indent, int block_indent)
+    {
+        if (m_base == -1 && indent > 0)
+        {
+            m_base = indent;
+        }
+        if (indent % m_base && block_indent)
+        {
+            throw exceptions::inconsistent_indentation(indent, m_base, VILI_EXC_INFO);
+        }
+        if (m_base <= 0)
+        {
+            return 0;
+        }
+        indent /= m_base; // Normalize indentation to "levels"
+        int64_t closed_blocks = 0;
+        if (m_current > indent)
+        {
+            closed_blocks = m_current - indent;
+        }
+        else if (m_current == indent && indent < block_indent)
+        {
+            closed_blocks = 1;
+        }
+        else if (m_current < indent)
+        {
+            if (indent - m_current > 1 || indent > block_indent)
+            {
+                throw exceptions::too_much_indentation(indent, VILI_EXC_INFO);
+            }
+        }
+        m_current = indent;
+        return closed_blocks;
+    }
+
+    int64_t indentation::base() const
+    {
+        return m_base;
+    }
+
+    int indentation::block_indent() const
+    {
+        return static_cast<int>(m_current) + 1;
+    }
+}
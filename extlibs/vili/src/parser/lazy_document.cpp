@@ -0,0 +1,388 @@
+#include <array>
+#include <cstring>
+
+#include <vili/exceptions.hpp>
+#include <vili/parser.hpp>
+#include <vili/parser/lazy_document.hpp>
+
+#include <tao/pegtl.hpp>
+#if defined(_POSIX_MAPPED_FILES) || defined(_WIN32)
+#include <tao/pegtl/mmap_input.hpp>
+#define VILI_MMAP_AVAILABLE
+#endif
+
+namespace peg = tao::pegtl;
+
+namespace vili::parser
+{
+    namespace
+    {
+        bool is_blank(char c)
+        {
+            return c == ' ' || c == '\t';
+        }
+
+        bool is_identifier_start(char c)
+        {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+        }
+
+        bool is_identifier_char(char c)
+        {
+            return is_identifier_start(c) || (c >= '0' && c <= '9');
+        }
+
+        /**
+         * \brief Bytes the structure scanner has to look at, anything else
+         *        (digits, separators, identifiers...) is skipped in bulk
+         */
+        constexpr std::array<bool, 256> make_structural_bytes()
+        {
+            std::array<bool, 256> table {};
+            for (const unsigned char c : std::string_view("\n\"#/*[]{}"))
+            {
+                table[c] = true;
+            }
+            return table;
+        }
+        constexpr std::array<bool, 256> structural_bytes = make_structural_bytes();
+
+        /**
+         * \brief Returns the key defined by the line starting at position
+         *        (empty if the line does not start with a key at indent columns)
+         */
+        std::string_view key_at(
+            std::string_view data, std::size_t position, std::size_t indent)
+        {
+            const std::size_t size = data.size();
+            std::size_t cursor = position;
+            while (cursor < size && is_blank(data[cursor]))
+            {
+                cursor++;
+            }
+            if (cursor - position != indent || cursor == size
+                || !is_identifier_start(data[cursor]))
+            {
+                return {};
+            }
+            const std::size_t key_begin = cursor;
+            while (cursor < size && is_identifier_char(data[cursor]))
+            {
+                cursor++;
+            }
+            const std::size_t key_end = cursor;
+            while (cursor < size && is_blank(data[cursor]))
+            {
+                cursor++;
+            }
+            if (cursor == size || data[cursor] != ':')
+            {
+                return {};
+            }
+            return data.substr(key_begin, key_end - key_begin);
+        }
+
+        /**
+         * \brief Scans data from position (a line start) and returns the start of the
+         *        next line holding a key at indent columns, outside of any string,
+         *        comment, array or brace-based object (data.size() if there is none)
+         * \param skip_first the line at position is scanned but never returned
+         */
+        std::size_t next_key_line(
+            std::string_view data, std::size_t position, std::size_t indent, bool skip_first)
+        {
+            const std::size_t size = data.size();
+            std::size_t depth = 0;
+            std::size_t comment_depth = 0;
+            bool line_start = !skip_first;
+            while (position < size)
+            {
+                if (line_start)
+                {
+                    line_start = false;
+                    if (depth == 0 && comment_depth == 0
+                        && !key_at(data, position, indent).empty())
+                    {
+                        return position;
+                    }
+                }
+                while (position < size
+                    && !structural_bytes[static_cast<unsigned char>(data[position])])
+                {
+                    position++;
+                }
+                if (position == size)
+                {
+                    break;
+                }
+                const char c = data[position++];
+                const char next = (position < size) ? data[position] : '\0';
+                if (comment_depth)
+                {
+                    if (c == '*' && next == '/')
+                    {
+                        comment_depth--;
+                        position++;
+                    }
+                    else if (c == '/' && next == '*')
+                    {
+                        comment_depth++;
+                        position++;
+                    }
+                    else if (c == '\n')
+                    {
+                        line_start = true;
+                    }
+                    continue;
+                }
+                switch (c)
+                {
+                case '\n':
+                    line_start = true;
+                    break;
+                case '"':
+                    while (position < size && data[position] != '"' && data[position] != '\n')
+                    {
+                        position += (data[position] == '\\') ? 2 : 1;
+                    }
+                    position = std::min(position + 1, size);
+                    break;
+                case '#':
+                {
+                    const void* line_end
+                        = std::memchr(data.data() + position, '\n', size - position);
+                    position = line_end
+                        ? static_cast<const char*>(line_end) - data.data()
+                        : size;
+                    break;
+                }
+                case '/':
+                    if (next == '*')
+                    {
+                        comment_depth++;
+                        position++;
+                    }
+                    break;
+                case '[':
+                case '{':
+                    depth++;
+                    break;
+                case ']':
+                case '}':
+                    depth -= (depth > 0);
+                    break;
+                default:
+                    break;
+                }
+            }
+            return size;
+        }
+
+        /**
+         * \brief Returns the start of the line following the one at position
+         */
+        std::size_t next_line(std::string_view data, std::size_t position)
+        {
+            const std::size_t line_end = data.find('\n', position);
+            return (line_end == std::string_view::npos) ? data.size() : line_end + 1;
+        }
+    }
+
+    std::vector<section> index_sections(std::string_view data, std::size_t indent)
+    {
+        std::vector<section> sections;
+        std::size_t position = next_key_line(data, 0, indent, false);
+        while (position < data.size())
+        {
+            const std::size_t end = next_key_line(data, position, indent, true);
+            sections.push_back(section { key_at(data, position, indent), position, end });
+            position = end;
+        }
+        return sections;
+    }
+
+    lazy_document::lazy_document(std::shared_ptr<const void> owner, std::string_view data)
+        : m_owner(std::move(owner))
+        , m_data(data)
+    {
+        for (const section& range : index_sections(m_data))
+        {
+            auto [root, inserted] = m_sections.try_emplace(range.key);
+            if (inserted)
+            {
+                root->second.key = range.key;
+                m_keys.push_back(range.key);
+            }
+            root->second.ranges.push_back(range);
+        }
+    }
+
+    lazy_document::root_section& lazy_document::find_section(std::string_view key)
+    {
+        const auto root = m_sections.find(key);
+        if (root == m_sections.end())
+        {
+            throw exceptions::unknown_child_node(key, VILI_EXC_INFO);
+        }
+        return root->second;
+    }
+
+    void lazy_document::index_children(root_section& root)
+    {
+        if (root.children_indexed)
+        {
+            return;
+        }
+        root.children_indexed = true;
+        // Redefined sections and inline values are only parsed as a whole
+        if (root.ranges.size() != 1)
+        {
+            return;
+        }
+        const section& range = root.ranges.front();
+        const std::string_view body = m_data.substr(range.begin, range.end - range.begin);
+        std::size_t after_key = body.find(':') + 1;
+        while (after_key < body.size() && is_blank(body[after_key]))
+        {
+            after_key++;
+        }
+        if (after_key < body.size() && body[after_key] != '\n' && body[after_key] != '#')
+        {
+            return;
+        }
+        // Children indentation is the one of the first line holding a key
+        std::size_t indent = 0;
+        for (std::size_t line = next_line(body, 0); line < body.size();
+             line = next_line(body, line))
+        {
+            std::size_t cursor = line;
+            while (cursor < body.size() && is_blank(body[cursor]))
+            {
+                cursor++;
+            }
+            if (cursor < body.size() && is_identifier_start(body[cursor]))
+            {
+                indent = cursor - line;
+                break;
+            }
+        }
+        if (indent == 0)
+        {
+            return;
+        }
+        const std::size_t first_child = next_line(body, 0);
+        for (section child : index_sections(body.substr(first_child), indent))
+        {
+            child.begin += range.begin + first_child;
+            child.end += range.begin + first_child;
+            root.children.push_back(child);
+        }
+    }
+
+    const std::vector<std::string_view>& lazy_document::keys() const
+    {
+        return m_keys;
+    }
+
+    bool lazy_document::contains(std::string_view key) const
+    {
+        return m_sections.find(key) != m_sections.end();
+    }
+
+    const node& lazy_document::at(std::string_view key)
+    {
+        if (const auto parsed = m_nodes.find(key); parsed != m_nodes.end())
+        {
+            return parsed->second;
+        }
+        const root_section& root = find_section(key);
+        state parser_state;
+        // Redefinitions of a root key are merged by the state, in order
+        for (const section& range : root.ranges)
+        {
+            parse_into(m_data.substr(range.begin, range.end - range.begin), parser_state);
+        }
+        m_partial_nodes.erase(root.key);
+        node& value = parser_state.root.at(std::string(root.key));
+        return m_nodes.try_emplace(root.key, std::move(value)).first->second;
+    }
+
+    const node& lazy_document::at(std::string_view key, std::string_view child)
+    {
+        const std::string child_key(child);
+        if (const auto parsed = m_nodes.find(key); parsed != m_nodes.end())
+        {
+            return parsed->second.at(child_key);
+        }
+        root_section& root = find_section(key);
+        index_children(root);
+        node& partial
+            = m_partial_nodes.try_emplace(root.key, vili::object {}).first->second;
+        if (partial.contains(child_key))
+        {
+            return partial.at(child_key);
+        }
+
+        state parser_state;
+        parse_into(std::string(root.key) + ":\n", parser_state);
+        bool found = false;
+        for (const section& range : root.children)
+        {
+            if (range.key == child)
+            {
+                parse_into(
+                    m_data.substr(range.begin, range.end - range.begin), parser_state);
+                found = true;
+            }
+        }
+        if (!found)
+        {
+            // Children could not be indexed (or child does not exist)
+            return at(key).at(child_key);
+        }
+        partial[child_key]
+            = std::move(parser_state.root.at(std::string(root.key)).at(child_key));
+        return partial.at(child_key);
+    }
+
+    node lazy_document::to_node()
+    {
+        node document = vili::object {};
+        for (const std::string_view key : m_keys)
+        {
+            at(key);
+            document.insert(std::string(key), std::move(m_nodes.at(key)));
+        }
+        m_nodes.clear();
+        return document;
+    }
+
+    lazy_document lazy_from_string(std::string data)
+    {
+        auto owner = std::make_shared<const std::string>(std::move(data));
+        const std::string_view view = *owner;
+        return lazy_document(std::move(owner), view);
+    }
+
+    lazy_document lazy_from_file(std::string_view path, const options& parser_options)
+    {
+        try
+        {
+#ifdef VILI_MMAP_AVAILABLE
+            if (parser_options.file_input == file_input_mode::mapped)
+            {
+                auto in = std::make_shared<const peg::mmap_input<>>(path);
+                const std::string_view view(in->begin(), in->size());
+                return lazy_document(std::move(in), view);
+            }
+#endif
+            auto in = std::make_shared<const peg::read_input<>>(path);
+            const std::string_view view(in->begin(), in->size());
+            return lazy_document(std::move(in), view);
+        }
+        catch (const std::system_error& e)
+        {
+            throw exceptions::file_not_found(path, VILI_EXC_INFO).nest(e);
+        }
+    }
+}
@@ -9,64 +9,42 @@ namespace vili::parser
     }
 
     state::state(const state& state)
-        : m_indent_base(state.m_indent_base)
+        : m_indentation(state.m_indentation.base())
         , root(state.root)
     {
         m_stack.emplace(&root, 0);
     }
 
-    state::state(state&& state)
-        : m_indent_base(state.m_indent_base)
-        , root(state.root)
+    state::state(state&& state) noexcept
+        : m_indentation(state.m_indentation.base())
+        , root(std::move(state.root))
     {
         m_stack.emplace(&root, 0);
     }
 
     void state::set_indent(int64_t indent)
     {
-        if (m_indent_base == -1 && indent > 0)
-        {
-            m_indent_base = indent;
-        }
-        if (indent % m_indent_base && m_stack.top().indent)
-        {
-            throw exceptions::inconsistent_indentation(
-                indent, m_indent_base, VILI_EXC_INFO);
-        }
-        if (m_indent_base > 0)
+        const int64_t closed_blocks
+            = m_indentation.update(indent, m_stack.top().indent);
+        for (int64_t block = 0; block < closed_blocks; block++)
         {
-            indent /= m_indent_base; // Normalize indentation to "levels"
-            if (m_indent_current > indent)
-            {
-                for (auto decrease_indent = m_indent_current; decrease_indent > indent;
-                     decrease_indent--)
-                {
-                    this->close_block();
-                }
-            }
-            else if (m_indent_current == indent && indent < m_stack.top().indent)
-            {
-                this->close_block();
-            }
-            else if (m_indent_current < indent)
-            {
-                if (indent - m_indent_current > 1 || indent > m_stack.top().indent)
-                {
-                    throw exceptions::too_much_indentation(indent, VILI_EXC_INFO);
-                }
-            }
-            m_indent_current = indent;
+            this->close_block();
         }
     }
 
+    int64_t state::indent_base() const
+    {
+        return m_indentation.base();
+    }
+
     void state::use_indent()
     {
-        m_stack.top().indent = static_cast<int>(m_indent_current) + 1;
+        m_stack.top().indent = m_indentation.block_indent();
     }
 
-    void state::set_active_identifier(std::string&& identifier)
+    void state::set_active_identifier(std::string_view identifier)
     {
-        m_identifier = identifier;
+        m_identifier.assign(identifier);
     }
 
     void state::open_block()
@@ -82,28 +60,29 @@ namespace vili::parser
     void state::push(node&& data)
     {
         node& top = *m_stack.top().item;
+        const bool is_container = data.is_container();
         if (top.is<array>())
         {
-            top.push(data);
-            if (data.is_container())
+            auto& vector = top.as<array>();
+            node& item = vector.emplace_back(std::move(data));
+            if (is_container)
             {
-                m_last_container = &top.back();
+                m_last_container = &item;
             }
         }
         else if (top.is<object>())
         {
-            if (top.contains(m_identifier))
+            auto& map = top.as<object>();
+            auto [element, inserted]
+                = map.try_emplace(std::move(m_identifier), std::move(data));
+            if (!inserted)
             {
                 // Object redefinition
-                top.at(m_identifier).merge(data);
-            }
-            else
-            {
-                top.insert(m_identifier, data);
+                element->second.merge(data);
             }
-            if (data.is_container())
+            if (is_container)
             {
-                m_last_container = &top.at(m_identifier);
+                m_last_container = &element->second;
             }
             m_identifier.clear();
         }
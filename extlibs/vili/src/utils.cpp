@@ -1,5 +1,7 @@
 #include <vili/utils.hpp>
 
+#include <version>
+
 #include <algorithm>
 #include <cctype>
 #ifdef __cpp_lib_to_chars
@@ -72,7 +74,7 @@ namespace vili::utils::string
         std::from_chars(input.data(), input.data() + input.size(), data_out);
         return data_out;
 #else
-        return std::stod(input.data());
+        return std::stod(std::string(input));
 #endif
     }
 
@@ -83,7 +85,7 @@ namespace vili::utils::string
         std::from_chars(input.data(), input.data() + input.size(), data_out);
         return data_out;
 #else
-        return std::stoll(input.data());
+        return std::stoll(std::string(input));
 #endif
     }
 
@@ -1,3 +1,5 @@
+#include <version>
+
 #include <array>
 #ifdef __cpp_lib_to_chars
 #include <charconv>
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <vili/node.hpp>
+
+#include <geometry.hpp>
+
+/**
+ * \brief Node of a bounding volume hierarchy stored in depth-first order : the left
+ *        child of an inner node follows it, first is the index of its right child.
+ *        Leaves (count > 0) hold the items [first, first + count)
+ */
+struct BvhNode
+{
+    Rect bounds;
+    uint32_t first = 0;
+    uint32_t count = 0;
+};
+
+struct Bvh
+{
+    std::vector<BvhNode> nodes;
+    /**
+     * \brief Item indexes in leaves order
+     */
+    std::vector<uint32_t> items;
+};
+
+/**
+ * \brief Builds a BVH over boxes, splits are picked with the surface area heuristic
+ *        (half perimeters in 2D) over binned box centers
+ */
+Bvh build_bvh(const std::vector<Rect>& boxes);
+
+/**
+ * \brief Builds the CollisionBvh section of a scene from its Collisions :
+ *
+ * CollisionBvh: { colliders: [<collider_id>, ...], bounds: [min x, min y, max x,
+ * max y, ...], nodes: [min x, min y, max x, max y, first, count, ...] }
+ * colliders are sorted in leaves order, bounds holds one AABB per collider and
+ * nodes 6 values per BvhNode (leaves items index colliders).
+ * \return a null node if the scene has no collider
+ */
+vili::node make_collision_bvh(const vili::object& scene);
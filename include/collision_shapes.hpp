@@ -0,0 +1,63 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <vili/node.hpp>
+
+struct CollisionShapeStats
+{
+    size_t shapes = 0;
+    size_t points_before = 0;
+    size_t points_after = 0;
+    size_t concave_shapes = 0;
+    size_t convex_parts = 0;
+};
+
+/**
+ * \brief Simplifies (tolerance > 0, in pixels) and optionally splits in convex parts
+ *        the polygons of the scene Collisions and of the tileset collisions
+ *        (analytic shapes are left untouched)
+ *
+ * A concave collider <id> is replaced by <id>_part<n> colliders, a concave tileset
+ * collision by one collision per part (sharing its tile id and tag).
+ */
+CollisionShapeStats optimize_collision_shapes(
+    vili::object& scene, double tolerance, bool decompose);
+
+/**
+ * \brief Deduplicated collision polygons, normalized so their bounding box starts
+ *        at (0, 0) and their first point is the smallest one (x, then y),
+ *        analytic shapes are not instanced
+ */
+class ShapeLibrary
+{
+private:
+    std::map<std::vector<std::pair<double, double>>, std::string> m_ids;
+    vili::node m_shapes = vili::object {};
+    size_t m_instances = 0;
+
+public:
+    /**
+     * \brief Replaces the points of a collision by a reference to its shape :
+     *        { shape: <shape_id>, x, y } where x, y is the offset of the shape
+     */
+    void instance(vili::node& collision);
+    /**
+     * \brief Instances every collider of a Collisions section
+     */
+    void instance_colliders(vili::node& collisions);
+    /**
+     * \brief Instances every tileset collision of a Tiles.sources section
+     */
+    void instance_tileset_collisions(vili::node& sources);
+
+    [[nodiscard]] size_t instances() const;
+    [[nodiscard]] size_t size() const;
+    /**
+     * \brief CollisionShapes section : { <shape_id>: { points } }
+     */
+    [[nodiscard]] const vili::node& shapes() const;
+};
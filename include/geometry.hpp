@@ -0,0 +1,150 @@
+#pragma once
+
+#include <vector>
+
+#include <vili/node.hpp>
+
+struct Point
+{
+    double x = 0;
+    double y = 0;
+};
+
+using Polygon = std::vector<Point>;
+
+/**
+ * \brief Axis-aligned rectangle, in pixels
+ */
+struct Rect
+{
+    double x = 0;
+    double y = 0;
+    double width = 0;
+    double height = 0;
+};
+
+/**
+ * \brief Returns true (and the rectangle) if polygon is an axis-aligned rectangle
+ */
+bool as_rect(const Polygon& polygon, Rect& rect);
+
+Polygon to_polygon(const Rect& rect);
+
+/**
+ * \brief Axis-aligned bounding box of a polygon
+ */
+Rect bounding_rect(const Polygon& polygon);
+
+/**
+ * \brief Smallest rectangle containing both rectangles
+ */
+Rect merge(const Rect& left, const Rect& right);
+
+Polygon translate(const Polygon& polygon, double x, double y);
+
+/**
+ * \brief Merges overlapping and adjacent rectangles into as few rectangles
+ *        as a greedy mesher finds, the covered area is unchanged
+ *
+ * Rectangles edges are projected on a compressed grid (one column / row per
+ * distinct x / y coordinate), covered cells are then merged in maximal horizontal
+ * runs that are extended downwards while the rows below are covered.
+ */
+std::vector<Rect> merge_rects(const std::vector<Rect>& rects);
+
+/**
+ * \brief Reads a polygon from a vili array of { x, y } points
+ */
+Polygon polygon_from_vili(const vili::node& points);
+
+/**
+ * \brief Integral coordinates are written as vili integers, others as numbers
+ */
+vili::node coordinate_to_vili(double value);
+
+/**
+ * \brief Writes a polygon as a vili array of { x, y } points,
+ *        integral coordinates are written as integers
+ */
+vili::node polygon_to_vili(const Polygon& polygon);
+
+/**
+ * \brief Simplifies a closed polygon with the Ramer-Douglas-Peucker algorithm,
+ *        points closer than tolerance to the simplified outline are removed
+ *        (the polygon is returned as is if fewer than 3 points would remain)
+ */
+Polygon simplify_polygon(const Polygon& polygon, double tolerance);
+
+bool is_convex(const Polygon& polygon);
+
+/**
+ * \brief Splits a simple polygon in convex parts : the polygon is triangulated by
+ *        ear clipping then triangles are merged back (Hertel-Mehlhorn) as long as
+ *        the merged parts stay convex
+ * \return the polygon itself if it is already convex or can not be triangulated
+ *         (self-intersecting outlines)
+ */
+std::vector<Polygon> convex_decomposition(const Polygon& polygon);
+
+enum class ShapeType
+{
+    Polygon,
+    Box,
+    Circle,
+    Capsule
+};
+
+/**
+ * \brief Collision shape, either a polygon or an analytic shape
+ *
+ * Circles and capsules are a segment (start == end for circles) swept by radius.
+ */
+struct Shape
+{
+    ShapeType type = ShapeType::Polygon;
+    Polygon points;
+    Rect box;
+    Point start;
+    Point end;
+    double radius = 0;
+};
+
+/**
+ * \brief Circle if the ellipse is round, capsule along its longest axis otherwise
+ */
+Shape make_ellipse_shape(const Rect& bounds);
+Shape make_box_shape(const Rect& box);
+
+Rect shape_bounds(const Shape& shape);
+
+/**
+ * \brief Returns true (and the rectangle) for boxes and axis-aligned rectangle polygons
+ */
+bool as_rect(const Shape& shape, Rect& rect);
+
+/**
+ * \brief Returns true if the shape covers part of the rectangle (touching its edges
+ *        does not count)
+ */
+bool overlaps(const Shape& shape, const Rect& rect);
+
+Shape translate(const Shape& shape, double x, double y);
+
+/**
+ * \brief Reads the shape of a collision : points: [...], box: { x, y, width, height },
+ *        circle: { x, y, radius } or capsule: { start: { x, y }, end: { x, y }, radius }
+ */
+Shape shape_from_vili(const vili::node& collision);
+
+/**
+ * \brief Writes the shape of a collision (in the format read by shape_from_vili)
+ */
+void shape_to_vili(const Shape& shape, vili::node& collision);
+
+/**
+ * \brief Applies Tiled tile flips to a shape defined in a width x height tile image :
+ *        diagonal flip (x / y swap) first, then horizontal and vertical flips
+ *        (polygons keep their winding order)
+ */
+Shape flip_shape(const Shape& shape, double width, double height, bool horizontal,
+    bool vertical, bool diagonal);
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <vector>
+
+#include <vili/node.hpp>
+
+#include <tilesets.hpp>
+
+/**
+ * \brief Builds the Navigation section of a scene : a walkability grid with a cell per
+ *        tile and an HPA* abstract graph over clusters of cluster_size x cluster_size
+ *        cells
+ *
+ * Navigation: { x, y, width, height (in tiles), blocked: [...], clusterSize, columns,
+ * rows (in clusters), clusterNodes: [...], nodes: [...], nodeEdges: [...],
+ * edges: [...], costs: [...] }
+ * blocked packs a bit per cell like collisionGrid.solid, set when a collider (or a tile
+ * collision if tile_collisions is true) covers part of the cell. nodes are the cells
+ * (y * width + x) of the transitions between neighbor clusters, grouped by cluster :
+ * cluster c holds nodes [clusterNodes[c], clusterNodes[c + 1]). Edges of node n are
+ * [nodeEdges[n], nodeEdges[n + 1]), edges holds their target node and costs their
+ * length in cells (8-connected moves without corner cutting). Must run before the
+ * tiles are chunked or encoded.
+ * \return a null node if the scene has no tile layer
+ */
+vili::node make_navigation(const vili::object& scene,
+    const std::vector<Tileset>& tilesets, unsigned int cluster_size, bool tile_collisions);
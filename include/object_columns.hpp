@@ -0,0 +1,17 @@
+#pragma once
+
+#include <vili/node.hpp>
+
+/**
+ * \brief Replaces the GameObjects section of a scene by GameObjectColumns, the objects
+ *        grouped by type with an array per field :
+ *
+ * GameObjectColumns: { <type>: { ids: [...], x: [...], y: [...], width: [...],
+ * height: [...], rotation: [...], properties: { <name>: [...] },
+ * propertyObjects: { <name>: [...] } } }
+ * Arrays hold a value per object of the group, in GameObjects order. A property
+ * missing on some objects of the group only holds the values of the objects listed
+ * (as indexes in ids) in propertyObjects.
+ * \return amount of groups
+ */
+size_t make_object_columns(vili::object& scene);
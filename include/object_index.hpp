@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+
+#include <vili/node.hpp>
+
+/**
+ * \brief Parses the cell size of the GameObjects index, "auto" (returns 0) or pixels
+ */
+double parse_object_index_cell_size(const std::string& cell_size);
+
+/**
+ * \brief Builds the GameObjectsIndex section of a scene, a uniform grid mapping cells
+ *        to the GameObjects overlapping them :
+ *
+ * GameObjectsIndex: { x, y, cellSize (in ScenePixels), columns, rows,
+ * objects: [<object_id>, ...], cells: [...], items: [...] }
+ * objects lists the GameObjects with a Requires.x / y, bounded by their (rotated)
+ * Requires.width / height. Objects of cell c (row * columns + column) are the items
+ * [cells[c], cells[c + 1]), each item is an index in objects.
+ * \param cell_size cell size in pixels, 0 picks it from the size and density of the
+ *        objects
+ * \return a null node if the scene has no positioned GameObject
+ */
+vili::node make_object_index(const vili::object& scene, double cell_size);
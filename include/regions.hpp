@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <vili/node.hpp>
+
+struct Region
+{
+    /**
+     * \brief Identifier of the region, x<column>_y<row>
+     */
+    std::string id;
+    unsigned int column = 0;
+    unsigned int row = 0;
+    /**
+     * \brief Area covered by the region, in tiles
+     */
+    vili::integer tile_x = 0;
+    vili::integer tile_y = 0;
+    vili::integer width = 0;
+    vili::integer height = 0;
+    vili::object scene;
+};
+
+struct RegionGrid
+{
+    /**
+     * \brief Size of a region, in tiles
+     */
+    unsigned int region_width = 0;
+    unsigned int region_height = 0;
+    unsigned int columns = 0;
+    unsigned int rows = 0;
+    std::vector<Region> regions;
+};
+
+/**
+ * \brief Parses a region size written as WxH (in tiles)
+ */
+void parse_region_size(const std::string& size, unsigned int& width, unsigned int& height);
+
+/**
+ * \brief Cuts a scene in regions of region_width x region_height tiles
+ *
+ * Each region gets the tiles it covers, the sprites (top-left corner), collisions
+ * (centroid) and GameObjects (position) located in it, elements outside of the map
+ * go to the closest region. Tile layers of a region are offset (x / y) to its
+ * position in the map, other elements keep their scene coordinates.
+ * Tiles.sources is left out of the regions, it is meant to be shared
+ * (written once and referenced by Tiles.sourcesFile).
+ */
+RegionGrid split_regions(
+    const vili::object& scene, unsigned int region_width, unsigned int region_height);
+
+/**
+ * \brief Builds the index of a region grid : bounds (in scene pixels) and
+ *        neighbors of each region
+ * \param region_files path of the scene of each region, in grid.regions order
+ */
+vili::node make_regions_index(const RegionGrid& grid, const vili::object& scene,
+    const std::vector<std::string>& region_files, const std::string& tilesets_file);
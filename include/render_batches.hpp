@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <vili/node.hpp>
+
+#include <tilesets.hpp>
+
+/*
+ * .batches sidecar : SidecarWriter layout with magic "OBRB", one block per
+ * (layer or chunk, tileset) pair holding the quads of its non-empty tiles.
+ * A quad is 4 vertices (top-left, top-right, bottom-right, bottom-left), a vertex
+ * is 4 float32 : x, y (map pixels) and u, v (texture pixels, flips applied)
+ */
+constexpr char RENDER_BATCHES_MAGIC[4] = { 'O', 'B', 'R', 'B' };
+constexpr uint32_t RENDER_BATCHES_VERSION = 1;
+constexpr uint32_t RENDER_BATCHES_VERTEX_SIZE = 4 * sizeof(float);
+
+/**
+ * \brief Builds the render batches of every layer (or chunk) of a scene Tiles section,
+ *        grouped by tileset texture, and writes them to a sidecar file
+ *
+ * Each layer or chunk gets a batches: { <tileset_id>: { file, offset, length,
+ * elementSize } } entry, collections of images get one <tileset_id>_<image> batch
+ * per image (index in the source images). Tiles taller than the map tiles are
+ * bottom-aligned like in Tiled.
+ * \param sidecar_reference path of the sidecar written in the scene
+ */
+void write_render_batches(vili::node& tiles, const std::vector<Tileset>& tilesets,
+    const std::string& sidecar_path, const std::string& sidecar_reference);
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <vili/node.hpp>
+
+/*
+ * Binary sidecar files layout (little-endian) :
+ *   header    : 4 bytes magic, uint32 version, uint32 block count, uint32 reserved
+ *   directory : per block, uint64 offset, uint64 length (bytes),
+ *               uint32 element size, uint32 reserved
+ *   blocks    : raw data, 8-bytes aligned
+ */
+class SidecarWriter
+{
+private:
+    std::string m_data;
+    size_t m_blocks;
+    size_t m_next_block = 0;
+
+public:
+    /**
+     * \param blocks amount of blocks that will be added (size of the directory)
+     */
+    SidecarWriter(const char (&magic)[4], uint32_t version, size_t blocks);
+
+    /**
+     * \brief Appends a block to the file
+     * \return reference to the block written in the scene
+     *         ({ file, offset, length, elementSize })
+     */
+    vili::node add_block(
+        const std::string& block, uint32_t element_size, const std::string& reference);
+    [[nodiscard]] size_t size() const;
+    void write(const std::string& path) const;
+};
+
+void append_little_endian(std::string& output, uint64_t value, size_t size);
+void append_float(std::string& output, float value);
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <functional>
+#include <string>
+
+#include <vili/node.hpp>
+
+/**
+ * \brief Splits the tiles of every layer of a scene Tiles section in chunks of
+ *        chunk_size x chunk_size tiles, chunks without any tile are dropped
+ *
+ * The layer tiles array is replaced by :
+ *   chunks: { width, height, bounds: { x, y, width, height } (in chunks, covering
+ *             every non-empty chunk), items: { x<cx>_y<cy>: { x, y, width, height,
+ *             tiles } } }
+ * Chunks on the right and bottom edges can be smaller than chunk_size.
+ */
+void chunk_tile_layers(vili::node& tiles, unsigned int chunk_size);
+
+/**
+ * \brief Grid of tile ids of a scene, either the tiles of a layer or of one of its chunks
+ */
+struct TileGrid
+{
+    const std::string& layer_id;
+    /**
+     * \brief Layer or chunk node holding the tiles
+     */
+    vili::node& owner;
+    vili::node& tiles;
+    /**
+     * \brief Position of the first tile of the grid in the map and width of the grid,
+     *        in tiles
+     */
+    vili::integer x;
+    vili::integer y;
+    vili::integer width;
+};
+
+/**
+ * \brief Smallest area (in tiles) holding every layer of a scene Tiles section,
+ *        layers must not be chunked
+ */
+void tile_layers_bounds(const vili::node& tiles, vili::integer& x, vili::integer& y,
+    vili::integer& width, vili::integer& height);
+
+/**
+ * \brief Calls callback for every grid of tile ids of a scene Tiles section
+ */
+void for_each_tile_grid(
+    vili::node& tiles, const std::function<void(const TileGrid& grid)>& callback);
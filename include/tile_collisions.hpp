@@ -0,0 +1,47 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include <vili/node.hpp>
+
+#include <tilesets.hpp>
+
+struct CollisionBakingStats
+{
+    size_t tile_shapes = 0;
+    size_t colliders = 0;
+};
+
+/**
+ * \brief Calls callback for the collision shapes of every tile of every layer, placed
+ *        in the scene (in ScenePixels) with the tile flips applied. Must run before
+ *        the tiles are chunked or encoded.
+ */
+void for_each_tile_collision(const vili::node& tiles,
+    const std::vector<Tileset>& tilesets,
+    const std::function<void(const TileShape& shape)>& callback);
+
+/**
+ * \brief Turns the collision shapes of the tiles of every layer into scene colliders
+ *
+ * Tile flips (GID flags) are applied to the shapes. Axis-aligned rectangles and
+ * boxes sharing a tag are merged in as few rectangle polygons as possible, other
+ * shapes are added as they are. Colliders are added to the Collisions section
+ * (tile_collider_<n>, in ScenePixels), must run before the tiles are chunked or
+ * encoded.
+ */
+CollisionBakingStats bake_tile_collisions(
+    vili::object& scene, const std::vector<Tileset>& tilesets);
+
+/**
+ * \brief Builds the collision grid of a scene Tiles section, covering every layer :
+ *
+ * collisionGrid: { x, y, width, height (in tiles), solid: [...], partial: [...] }
+ * solid is a bitset of width * height bits packed in 32-bit words (cell
+ * y * width + x is bit cell % 32 of word cell / 32), set when the collisions of a
+ * tile of any layer cover the whole cell. partial lists (cell, GID) pairs for the
+ * other tiles with collisions, sorted by cell, their shapes stay in Tiles.sources.
+ * Must run before the tiles are chunked or encoded.
+ */
+vili::node make_collision_grid(const vili::node& tiles, const std::vector<Tileset>& tilesets);
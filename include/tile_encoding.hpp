@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <vili/node.hpp>
+
+/**
+ * \brief Storage of a grid of tile ids in the scene
+ *
+ * Dense  : plain array of tile ids (unchanged layout)
+ * RunLength : { encoding: "rle", size, runs: [count, tile, count, tile...] }
+ * Sparse : { encoding: "sparse", size, mask: [32-bits words, bit set for non-empty
+ *          tiles], values: [non-empty tiles in grid order] }
+ */
+enum class TileEncoding
+{
+    Dense,
+    RunLength,
+    Sparse
+};
+
+struct EncodedTiles
+{
+    TileEncoding encoding = TileEncoding::Dense;
+    vili::node tiles;
+    /**
+     * \brief Sizes are measured as varint bytes (as written by the binary format)
+     */
+    size_t dense_size = 0;
+    size_t encoded_size = 0;
+    /**
+     * \brief Shannon entropy of the tile ids, in bits per tile
+     */
+    double entropy = 0;
+};
+
+struct TileLayerStats
+{
+    std::string layer_id;
+    /**
+     * \brief Amount of grids (the layer or its chunks) stored with each encoding,
+     *        indexed by TileEncoding
+     */
+    size_t grids[3] = { 0, 0, 0 };
+    size_t dense_size = 0;
+    size_t encoded_size = 0;
+    /**
+     * \brief Entropy of the grids weighted by their amount of tiles
+     */
+    double entropy = 0;
+    size_t tiles = 0;
+};
+
+std::string to_string(TileEncoding encoding);
+/**
+ * \brief Describes the encodings used by a layer ("rle" or "12 dense, 3 sparse")
+ */
+std::string to_string(const TileLayerStats& stats);
+
+/**
+ * \brief Picks the smallest encoding of a grid of tile ids,
+ *        dense is kept unless another encoding is strictly smaller
+ */
+EncodedTiles encode_tiles(vili::array tiles);
+
+/**
+ * \brief Encodes the tiles of every layer (or of every chunk of a layer)
+ *        of a scene Tiles section
+ * \return encodings chosen for each layer, for conversion stats
+ */
+std::vector<TileLayerStats> encode_tile_layers(vili::node& tiles);
+
+/**
+ * \brief Moves the flip flags out of the GIDs of every layer (or chunk) of a scene
+ *        Tiles section, tiles only keep tile ids and grids holding flipped tiles get
+ *        flags: [...] with the 4 flag bits (GID >> 28) of 8 tiles per 32-bit word
+ *        (tile i in bits 4 * (i % 8) to 4 * (i % 8) + 3 of word i / 8)
+ * \return amount of flipped tiles
+ */
+size_t split_tile_flags(vili::node& tiles);
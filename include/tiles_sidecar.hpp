@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <vili/node.hpp>
+
+/*
+ * .tiles sidecar : SidecarWriter layout with magic "OBTL", one block of raw
+ * tile ids (uint16 or uint32 elements) per layer or chunk
+ */
+constexpr char TILES_SIDECAR_MAGIC[4] = { 'O', 'B', 'T', 'L' };
+constexpr uint32_t TILES_SIDECAR_VERSION = 1;
+
+/**
+ * \brief Moves the dense tiles of every layer (or chunk) of a scene Tiles section
+ *        to a sidecar file, each grid only keeps the location of its block
+ *        ({ file, offset, length, elementSize }), grids use uint16 elements
+ *        when every tile id fits in
+ * \param sidecar_reference path of the sidecar written in the scene
+ */
+void write_tiles_sidecar(
+    vili::node& tiles, const std::string& sidecar_path, const std::string& sidecar_reference);
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <vili/node.hpp>
+
+#include <geometry.hpp>
+
+/**
+ * \brief Flags stored in the highest bits of a Tiled GID
+ */
+constexpr uint32_t FLIPPED_HORIZONTALLY_FLAG = 0x80000000;
+constexpr uint32_t FLIPPED_VERTICALLY_FLAG = 0x40000000;
+constexpr uint32_t FLIPPED_DIAGONALLY_FLAG = 0x20000000;
+constexpr uint32_t ROTATED_HEXAGONAL_120_FLAG = 0x10000000;
+constexpr uint32_t TILE_FLAGS_MASK = 0xF0000000;
+
+/**
+ * \brief Area of a tile in its texture, in pixels
+ */
+struct TileRect
+{
+    uint32_t x = 0;
+    uint32_t y = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+};
+
+/**
+ * \brief Collision shape of a tile, in pixels relative to the tile image
+ */
+struct TileShape
+{
+    Shape shape;
+    std::string tag;
+};
+
+struct Tileset
+{
+    std::string id;
+    uint32_t first_tile_id = 0;
+    uint32_t tile_count = 0;
+    uint32_t columns = 0;
+    uint32_t margin = 0;
+    uint32_t spacing = 0;
+    uint32_t tile_width = 0;
+    uint32_t tile_height = 0;
+    /**
+     * \brief Texture rect of every tile, indexed by local id (starting at 0)
+     */
+    std::vector<TileRect> rects;
+    /**
+     * \brief Collections of images only : index in the source images of every tile,
+     *        -1 for the ids without any tile
+     */
+    std::vector<int32_t> images;
+    /**
+     * \brief Collision shapes of every tile, indexed by local id
+     */
+    std::vector<std::vector<TileShape>> collisions;
+
+    [[nodiscard]] bool is_collection() const;
+    /**
+     * \brief Texture rect of a tile of the tileset (local_id starts at 0)
+     */
+    [[nodiscard]] const TileRect& tile_rect(uint32_t local_id) const;
+};
+
+/**
+ * \brief Reads the tilesets of a scene Tiles.sources section, sorted by firstTileId
+ */
+std::vector<Tileset> load_tilesets(const vili::node& sources);
+
+/**
+ * \brief Finds the tileset a GID belongs to (flags are ignored)
+ * \return nullptr for empty tiles and GIDs outside of every tileset
+ */
+const Tileset* find_tileset(const std::vector<Tileset>& tilesets, uint32_t gid);
+
+/**
+ * \brief Adds the precomputed tile rects of every tileset to a scene Tiles.sources section
+ *
+ * tileRects: [x, y, width, height, ...] holds 4 integers per local tile id, collections
+ * of images also get tileImages: [...], the index in images of every local tile id
+ * (-1 for the ids without any tile).
+ */
+void add_tile_rect_tables(vili::node& sources, const std::vector<Tileset>& tilesets);
+
+/**
+ * \brief Dense GID (flags removed) to tileset table, values are indexes in tilesets
+ *        or -1 for the GIDs that do not belong to any tileset
+ */
+std::vector<int32_t> make_tile_sources(const std::vector<Tileset>& tilesets);
+
+/**
+ * \brief Builds the Tiles.sourceIndex section of a scene :
+ *        { sources: [<tileset_id>, ...], tiles: [<index in sources>, ...] }
+ *        where tiles is the table of make_tile_sources
+ */
+vili::node make_source_index(const std::vector<Tileset>& tilesets);
+
+/**
+ * \brief Lists the tilesets referenced by the tiles of every layer of a scene Tiles
+ *        section (sources: [<tileset_id>, ...] in each layer) and by the whole scene
+ *        (Tiles.usedSources), must run before the tiles are chunked or encoded
+ */
+void add_tileset_usage(vili::node& tiles, const std::vector<Tileset>& tilesets);
@@ -0,0 +1,240 @@
+#include <algorithm>
+#include <array>
+#include <limits>
+
+#include <collision_bvh.hpp>
+
+namespace
+{
+    constexpr size_t SAH_BINS = 16;
+    constexpr uint32_t MAX_LEAF_SIZE = 4;
+    constexpr double TRAVERSAL_COST = 1.0;
+    constexpr double INTERSECTION_COST = 1.0;
+
+    double half_perimeter(const Rect& rect)
+    {
+        return rect.width + rect.height;
+    }
+
+    double center(const Rect& rect, int axis)
+    {
+        return (axis == 0) ? rect.x + rect.width / 2 : rect.y + rect.height / 2;
+    }
+
+    size_t bin_index(double value, double min, double extent)
+    {
+        return std::min(SAH_BINS - 1, static_cast<size_t>((value - min) / extent * SAH_BINS));
+    }
+
+    struct Bin
+    {
+        Rect bounds;
+        uint32_t count = 0;
+    };
+
+    class BvhBuilder
+    {
+    private:
+        const std::vector<Rect>& m_boxes;
+        Bvh m_bvh;
+
+        Rect bounds_of(uint32_t first, uint32_t last) const
+        {
+            Rect bounds = m_boxes[m_bvh.items[first]];
+            for (uint32_t item = first + 1; item < last; item++)
+            {
+                bounds = merge(bounds, m_boxes[m_bvh.items[item]]);
+            }
+            return bounds;
+        }
+
+        /**
+         * \brief Finds the cheapest binned split of items [first, last)
+         * \return the split position (first if keeping a leaf is cheaper)
+         */
+        uint32_t split(uint32_t first, uint32_t last, const Rect& bounds)
+        {
+            const uint32_t count = last - first;
+            double best_cost = INTERSECTION_COST * count;
+            int best_axis = -1;
+            size_t best_bin = 0;
+            double best_min = 0;
+            double best_extent = 0;
+
+            for (int axis = 0; axis < 2; axis++)
+            {
+                double min_center = std::numeric_limits<double>::max();
+                double max_center = std::numeric_limits<double>::lowest();
+                for (uint32_t item = first; item < last; item++)
+                {
+                    const double item_center = center(m_boxes[m_bvh.items[item]], axis);
+                    min_center = std::min(min_center, item_center);
+                    max_center = std::max(max_center, item_center);
+                }
+                const double extent = max_center - min_center;
+                if (extent <= 0)
+                {
+                    continue;
+                }
+
+                std::array<Bin, SAH_BINS> bins {};
+                for (uint32_t item = first; item < last; item++)
+                {
+                    const Rect& box = m_boxes[m_bvh.items[item]];
+                    Bin& bin = bins[bin_index(center(box, axis), min_center, extent)];
+                    bin.bounds = bin.count ? merge(bin.bounds, box) : box;
+                    bin.count++;
+                }
+
+                // Costs of the right sides, accumulated from the last bin
+                std::array<double, SAH_BINS> right_costs {};
+                Rect right_bounds;
+                uint32_t right_count = 0;
+                for (size_t bin = SAH_BINS - 1; bin > 0; bin--)
+                {
+                    if (bins[bin].count)
+                    {
+                        right_bounds = right_count ? merge(right_bounds, bins[bin].bounds)
+                                                   : bins[bin].bounds;
+                        right_count += bins[bin].count;
+                    }
+                    right_costs[bin]
+                        = right_count ? half_perimeter(right_bounds) * right_count : 0;
+                }
+                Rect left_bounds;
+                uint32_t left_count = 0;
+                for (size_t bin = 0; bin < SAH_BINS - 1; bin++)
+                {
+                    if (bins[bin].count)
+                    {
+                        left_bounds = left_count ? merge(left_bounds, bins[bin].bounds)
+                                                 : bins[bin].bounds;
+                        left_count += bins[bin].count;
+                    }
+                    if (left_count == 0 || left_count == count)
+                    {
+                        continue;
+                    }
+                    const double parent_area = std::max(half_perimeter(bounds), 1e-9);
+                    const double cost = TRAVERSAL_COST
+                        + INTERSECTION_COST
+                            * (half_perimeter(left_bounds) * left_count
+                                + right_costs[bin + 1])
+                            / parent_area;
+                    if (cost < best_cost)
+                    {
+                        best_cost = cost;
+                        best_axis = axis;
+                        best_bin = bin;
+                        best_min = min_center;
+                        best_extent = extent;
+                    }
+                }
+            }
+
+            if (best_axis < 0)
+            {
+                // Identical centers : big leaves are still split in two halves
+                return (count > MAX_LEAF_SIZE) ? first + count / 2 : first;
+            }
+            const auto middle = std::partition(m_bvh.items.begin() + first,
+                m_bvh.items.begin() + last,
+                [&](uint32_t item)
+                {
+                    const double item_center = center(m_boxes[item], best_axis);
+                    return bin_index(item_center, best_min, best_extent) <= best_bin;
+                });
+            return static_cast<uint32_t>(middle - m_bvh.items.begin());
+        }
+
+        void build(uint32_t first, uint32_t last)
+        {
+            const size_t node = m_bvh.nodes.size();
+            const Rect bounds = bounds_of(first, last);
+            m_bvh.nodes.push_back(BvhNode { bounds, first, last - first });
+            if (last - first <= 1)
+            {
+                return;
+            }
+            const uint32_t middle = split(first, last, bounds);
+            if (middle == first || middle == last)
+            {
+                return;
+            }
+            build(first, middle);
+            m_bvh.nodes[node].first = static_cast<uint32_t>(m_bvh.nodes.size());
+            m_bvh.nodes[node].count = 0;
+            build(middle, last);
+        }
+
+    public:
+        explicit BvhBuilder(const std::vector<Rect>& boxes)
+            : m_boxes(boxes)
+        {
+        }
+
+        Bvh build()
+        {
+            m_bvh.items.resize(m_boxes.size());
+            for (uint32_t item = 0; item < m_boxes.size(); item++)
+            {
+                m_bvh.items[item] = item;
+            }
+            if (!m_boxes.empty())
+            {
+                build(0, static_cast<uint32_t>(m_boxes.size()));
+            }
+            return std::move(m_bvh);
+        }
+    };
+
+    void push_bounds(vili::array& values, const Rect& rect)
+    {
+        values.push_back(coordinate_to_vili(rect.x));
+        values.push_back(coordinate_to_vili(rect.y));
+        values.push_back(coordinate_to_vili(rect.x + rect.width));
+        values.push_back(coordinate_to_vili(rect.y + rect.height));
+    }
+}
+
+Bvh build_bvh(const std::vector<Rect>& boxes)
+{
+    return BvhBuilder(boxes).build();
+}
+
+vili::node make_collision_bvh(const vili::object& scene)
+{
+    const auto collisions = scene.find("Collisions");
+    if (collisions == scene.end() || collisions->second.empty())
+    {
+        return vili::node {};
+    }
+    std::vector<std::string> collider_ids;
+    std::vector<Rect> boxes;
+    for (const auto& [collider_id, collider] : collisions->second.items())
+    {
+        collider_ids.push_back(collider_id);
+        boxes.push_back(shape_bounds(shape_from_vili(collider)));
+    }
+    const Bvh bvh = build_bvh(boxes);
+
+    vili::array colliders;
+    vili::array bounds;
+    colliders.reserve(bvh.items.size());
+    bounds.reserve(bvh.items.size() * 4);
+    for (const uint32_t item : bvh.items)
+    {
+        colliders.emplace_back(collider_ids[item]);
+        push_bounds(bounds, boxes[item]);
+    }
+    vili::array nodes;
+    nodes.reserve(bvh.nodes.size() * 6);
+    for (const BvhNode& node : bvh.nodes)
+    {
+        push_bounds(nodes, node.bounds);
+        nodes.emplace_back(static_cast<vili::integer>(node.first));
+        nodes.emplace_back(static_cast<vili::integer>(node.count));
+    }
+    return vili::make_object("colliders", std::move(colliders), "bounds",
+        std::move(bounds), "nodes", std::move(nodes));
+}
@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <string>
+
+#include <collision_shapes.hpp>
+#include <geometry.hpp>
+
+namespace
+{
+    std::vector<Polygon> optimize_shape(const vili::node& points, double tolerance,
+        bool decompose, CollisionShapeStats& stats)
+    {
+        const Polygon polygon = polygon_from_vili(points);
+        const Polygon simplified = simplify_polygon(polygon, tolerance);
+        stats.shapes++;
+        stats.points_before += polygon.size();
+        stats.points_after += simplified.size();
+        if (!decompose || is_convex(simplified))
+        {
+            return { simplified };
+        }
+        std::vector<Polygon> parts = convex_decomposition(simplified);
+        stats.concave_shapes++;
+        stats.convex_parts += parts.size();
+        return parts;
+    }
+
+    /**
+     * \brief Copy of collision with points replaced by part
+     */
+    vili::node make_part(const vili::node& collision, const Polygon& part)
+    {
+        vili::node collision_part = vili::object {};
+        for (const auto& [key, value] : collision.items())
+        {
+            collision_part[key] = (key == "points") ? polygon_to_vili(part) : value;
+        }
+        return collision_part;
+    }
+}
+
+CollisionShapeStats optimize_collision_shapes(
+    vili::object& scene, double tolerance, bool decompose)
+{
+    CollisionShapeStats stats;
+    if (scene.find("Collisions") != scene.end())
+    {
+        vili::node optimized = vili::object {};
+        for (const auto& [collision_id, collision] : scene["Collisions"].items())
+        {
+            // Analytic shapes (boxes, circles, capsules) are kept as they are
+            if (!collision.contains("points"))
+            {
+                optimized[collision_id] = collision;
+                continue;
+            }
+            const std::vector<Polygon> parts
+                = optimize_shape(collision.at("points"), tolerance, decompose, stats);
+            for (size_t part = 0; part < parts.size(); part++)
+            {
+                const std::string part_id = (parts.size() == 1)
+                    ? collision_id
+                    : collision_id + "_part" + std::to_string(part);
+                optimized[part_id] = make_part(collision, parts[part]);
+            }
+        }
+        scene["Collisions"] = std::move(optimized);
+    }
+
+    for (auto& [tileset_id, source] : scene["Tiles"]["sources"].items())
+    {
+        if (!source.contains("collisions"))
+        {
+            continue;
+        }
+        vili::node optimized = vili::array {};
+        for (const vili::node& collision : source.at("collisions"))
+        {
+            if (!collision.contains("points"))
+            {
+                optimized.push(collision);
+                continue;
+            }
+            for (const Polygon& part :
+                optimize_shape(collision.at("points"), tolerance, decompose, stats))
+            {
+                optimized.push(make_part(collision, part));
+            }
+        }
+        source["collisions"] = std::move(optimized);
+    }
+    return stats;
+}
+
+void ShapeLibrary::instance(vili::node& collision)
+{
+    if (!collision.contains("points"))
+    {
+        return;
+    }
+    const Polygon polygon = polygon_from_vili(collision.at("points"));
+    const Rect bounds = bounding_rect(polygon);
+    std::vector<std::pair<double, double>> key;
+    key.reserve(polygon.size());
+    for (const Point& point : polygon)
+    {
+        key.emplace_back(point.x - bounds.x, point.y - bounds.y);
+    }
+    std::rotate(key.begin(), std::min_element(key.begin(), key.end()), key.end());
+
+    auto [shape, inserted] = m_ids.try_emplace(key, "shape_" + std::to_string(m_ids.size()));
+    if (inserted)
+    {
+        Polygon normalized;
+        normalized.reserve(key.size());
+        for (const auto& [x, y] : key)
+        {
+            normalized.push_back(Point { x, y });
+        }
+        m_shapes[shape->second] = vili::make_object("points", polygon_to_vili(normalized));
+    }
+
+    vili::node instance = vili::object {};
+    for (const auto& [key_name, value] : collision.items())
+    {
+        if (key_name == "points")
+        {
+            instance["shape"] = shape->second;
+            instance["x"] = coordinate_to_vili(bounds.x);
+            instance["y"] = coordinate_to_vili(bounds.y);
+        }
+        else
+        {
+            instance[key_name] = value;
+        }
+    }
+    collision = std::move(instance);
+    m_instances++;
+}
+
+void ShapeLibrary::instance_colliders(vili::node& collisions)
+{
+    for (auto& [collider_id, collider] : collisions.items())
+    {
+        instance(collider);
+    }
+}
+
+void ShapeLibrary::instance_tileset_collisions(vili::node& sources)
+{
+    for (auto& [tileset_id, source] : sources.items())
+    {
+        if (source.contains("collisions"))
+        {
+            for (vili::node& collision : source["collisions"])
+            {
+                instance(collision);
+            }
+        }
+    }
+}
+
+size_t ShapeLibrary::instances() const
+{
+    return m_instances;
+}
+
+size_t ShapeLibrary::size() const
+{
+    return m_ids.size();
+}
+
+const vili::node& ShapeLibrary::shapes() const
+{
+    return m_shapes;
+}
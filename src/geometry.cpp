@@ -0,0 +1,735 @@
+#include <algorithm>
+#include <cmath>
+
+#include <geometry.hpp>
+
+namespace
+{
+    Point point_from_vili(const vili::node& point)
+    {
+        return Point {
+            point.at("x").as<vili::number>(), point.at("y").as<vili::number>() };
+    }
+
+    vili::node point_to_vili(const Point& point)
+    {
+        return vili::make_object(
+            "x", coordinate_to_vili(point.x), "y", coordinate_to_vili(point.y));
+    }
+
+    size_t coordinate_index(const std::vector<double>& coordinates, double value)
+    {
+        return std::lower_bound(coordinates.begin(), coordinates.end(), value)
+            - coordinates.begin();
+    }
+
+    double cross(const Point& origin, const Point& a, const Point& b)
+    {
+        return (a.x - origin.x) * (b.y - origin.y) - (a.y - origin.y) * (b.x - origin.x);
+    }
+
+    double signed_area(const Polygon& polygon)
+    {
+        double area = 0;
+        for (size_t index = 0; index < polygon.size(); index++)
+        {
+            const Point& point = polygon[index];
+            const Point& next = polygon[(index + 1) % polygon.size()];
+            area += point.x * next.y - next.x * point.y;
+        }
+        return area / 2;
+    }
+
+    double distance_to_segment(const Point& point, const Point& start, const Point& end)
+    {
+        const double dx = end.x - start.x;
+        const double dy = end.y - start.y;
+        const double length = dx * dx + dy * dy;
+        const double projection = (point.x - start.x) * dx + (point.y - start.y) * dy;
+        const double t = (length > 0) ? std::clamp(projection / length, 0.0, 1.0) : 0.0;
+        return std::hypot(point.x - (start.x + t * dx), point.y - (start.y + t * dy));
+    }
+
+    double distance_to_rect(const Point& point, const Rect& rect)
+    {
+        const double dx
+            = std::max({ rect.x - point.x, 0.0, point.x - rect.x - rect.width });
+        const double dy
+            = std::max({ rect.y - point.y, 0.0, point.y - rect.y - rect.height });
+        return std::hypot(dx, dy);
+    }
+
+    /**
+     * \brief Liang-Barsky test of a segment against a rectangle (edges included)
+     */
+    bool segment_intersects_rect(const Point& start, const Point& end, const Rect& rect)
+    {
+        const double dx = end.x - start.x;
+        const double dy = end.y - start.y;
+        const double directions[4] = { -dx, dx, -dy, dy };
+        const double distances[4] = { start.x - rect.x, rect.x + rect.width - start.x,
+            start.y - rect.y, rect.y + rect.height - start.y };
+        double enter = 0;
+        double leave = 1;
+        for (int edge = 0; edge < 4; edge++)
+        {
+            if (directions[edge] == 0)
+            {
+                if (distances[edge] < 0)
+                {
+                    return false;
+                }
+                continue;
+            }
+            const double t = distances[edge] / directions[edge];
+            if (directions[edge] < 0)
+            {
+                enter = std::max(enter, t);
+            }
+            else
+            {
+                leave = std::min(leave, t);
+            }
+        }
+        return enter <= leave;
+    }
+
+    /**
+     * \brief Part of a polygon inside a rectangle (Sutherland-Hodgman clipping)
+     */
+    Polygon clip_polygon(const Polygon& polygon, const Rect& rect)
+    {
+        // Left, right, top and bottom edges, as a coordinate bound and a side to keep
+        const double bounds[4]
+            = { rect.x, rect.x + rect.width, rect.y, rect.y + rect.height };
+        Polygon clipped = polygon;
+        for (int edge = 0; edge < 4 && !clipped.empty(); edge++)
+        {
+            const bool along_x = edge < 2;
+            const double side = (edge % 2) ? -1 : 1;
+            const auto coordinate
+                = [along_x](const Point& point) { return along_x ? point.x : point.y; };
+            const auto inside = [&](const Point& point)
+            { return side * (coordinate(point) - bounds[edge]) >= 0; };
+            const Polygon input = std::move(clipped);
+            clipped.clear();
+            for (size_t index = 0; index < input.size(); index++)
+            {
+                const Point& previous = input[(index + input.size() - 1) % input.size()];
+                const Point& current = input[index];
+                if (inside(previous) != inside(current))
+                {
+                    const double t = (bounds[edge] - coordinate(previous))
+                        / (coordinate(current) - coordinate(previous));
+                    clipped.push_back(Point { previous.x + t * (current.x - previous.x),
+                        previous.y + t * (current.y - previous.y) });
+                }
+                if (inside(current))
+                {
+                    clipped.push_back(current);
+                }
+            }
+        }
+        return clipped;
+    }
+
+    /**
+     * \brief Keeps the points of the open chain polygon[first..last] that are needed
+     *        to stay within tolerance (last excluded from the output)
+     */
+    void simplify_chain(const Polygon& polygon, size_t first, size_t last,
+        double tolerance, Polygon& output)
+    {
+        const Point& start = polygon[first];
+        const Point& end = polygon[last % polygon.size()];
+        double max_distance = 0;
+        size_t farthest = first;
+        for (size_t index = first + 1; index < last; index++)
+        {
+            const double distance = distance_to_segment(polygon[index], start, end);
+            if (distance > max_distance)
+            {
+                max_distance = distance;
+                farthest = index;
+            }
+        }
+        if (max_distance > tolerance)
+        {
+            simplify_chain(polygon, first, farthest, tolerance, output);
+            simplify_chain(polygon, farthest, last, tolerance, output);
+        }
+        else
+        {
+            output.push_back(start);
+        }
+    }
+
+    bool in_triangle(const Point& point, const Point& a, const Point& b, const Point& c)
+    {
+        return cross(a, b, point) >= 0 && cross(b, c, point) >= 0
+            && cross(c, a, point) >= 0;
+    }
+
+    bool same_point(const Point& a, const Point& b)
+    {
+        return a.x == b.x && a.y == b.y;
+    }
+
+    /**
+     * \brief Ear clipping triangulation of a counter-clockwise polygon,
+     *        returns triangles as indexes in polygon (empty on failure)
+     */
+    std::vector<std::vector<size_t>> triangulate(const Polygon& polygon)
+    {
+        std::vector<size_t> remaining(polygon.size());
+        for (size_t index = 0; index < polygon.size(); index++)
+        {
+            remaining[index] = index;
+        }
+        std::vector<std::vector<size_t>> triangles;
+        while (remaining.size() > 3)
+        {
+            bool clipped = false;
+            const size_t count = remaining.size();
+            for (size_t index = 0; index < count && !clipped; index++)
+            {
+                const size_t previous = remaining[(index + count - 1) % count];
+                const size_t current = remaining[index];
+                const size_t next = remaining[(index + 1) % count];
+                const Point& a = polygon[previous];
+                const Point& b = polygon[current];
+                const Point& c = polygon[next];
+                if (cross(a, b, c) <= 0)
+                {
+                    continue;
+                }
+                const bool contains_vertex
+                    = std::any_of(remaining.begin(), remaining.end(), [&](size_t other)
+                    {
+                        const Point& point = polygon[other];
+                        return !same_point(point, a) && !same_point(point, b)
+                            && !same_point(point, c) && in_triangle(point, a, b, c);
+                    });
+                if (!contains_vertex)
+                {
+                    triangles.push_back({ previous, current, next });
+                    remaining.erase(remaining.begin() + index);
+                    clipped = true;
+                }
+            }
+            if (!clipped)
+            {
+                return {};
+            }
+        }
+        triangles.push_back(remaining);
+        return triangles;
+    }
+
+    /**
+     * \brief Merges two parts sharing the edge a -> b (b -> a in other),
+     *        returns an empty part if they do not share it
+     */
+    std::vector<size_t> merge_parts(const std::vector<size_t>& part,
+        const std::vector<size_t>& other)
+    {
+        for (size_t edge = 0; edge < part.size(); edge++)
+        {
+            const size_t a = part[edge];
+            const size_t b = part[(edge + 1) % part.size()];
+            for (size_t other_edge = 0; other_edge < other.size(); other_edge++)
+            {
+                if (other[other_edge] != b || other[(other_edge + 1) % other.size()] != a)
+                {
+                    continue;
+                }
+                // part from b around to a, then other between a and b
+                std::vector<size_t> merged;
+                merged.reserve(part.size() + other.size() - 2);
+                for (size_t offset = 1; offset <= part.size(); offset++)
+                {
+                    merged.push_back(part[(edge + offset) % part.size()]);
+                }
+                for (size_t offset = 2; offset < other.size(); offset++)
+                {
+                    merged.push_back(other[(other_edge + offset) % other.size()]);
+                }
+                return merged;
+            }
+        }
+        return {};
+    }
+
+    Polygon part_polygon(const Polygon& polygon, const std::vector<size_t>& part)
+    {
+        Polygon points;
+        points.reserve(part.size());
+        for (const size_t index : part)
+        {
+            points.push_back(polygon[index]);
+        }
+        return points;
+    }
+}
+
+bool as_rect(const Polygon& polygon, Rect& rect)
+{
+    if (polygon.size() != 4)
+    {
+        return false;
+    }
+    const auto [min_x, max_x] = std::minmax({ polygon[0].x, polygon[1].x, polygon[2].x,
+        polygon[3].x });
+    const auto [min_y, max_y] = std::minmax({ polygon[0].y, polygon[1].y, polygon[2].y,
+        polygon[3].y });
+    // Every point is a distinct corner and consecutive points share an x or a y
+    for (size_t index = 0; index < polygon.size(); index++)
+    {
+        const Point& point = polygon[index];
+        const Point& next = polygon[(index + 1) % polygon.size()];
+        const bool is_corner = (point.x == min_x || point.x == max_x)
+            && (point.y == min_y || point.y == max_y);
+        if (!is_corner || ((point.x != next.x) == (point.y != next.y)))
+        {
+            return false;
+        }
+    }
+    if (min_x == max_x || min_y == max_y)
+    {
+        return false;
+    }
+    rect = Rect { min_x, min_y, max_x - min_x, max_y - min_y };
+    return true;
+}
+
+Polygon to_polygon(const Rect& rect)
+{
+    return Polygon { { rect.x, rect.y }, { rect.x + rect.width, rect.y },
+        { rect.x + rect.width, rect.y + rect.height }, { rect.x, rect.y + rect.height } };
+}
+
+Rect bounding_rect(const Polygon& polygon)
+{
+    if (polygon.empty())
+    {
+        return Rect {};
+    }
+    double min_x = polygon.front().x;
+    double min_y = polygon.front().y;
+    double max_x = min_x;
+    double max_y = min_y;
+    for (const Point& point : polygon)
+    {
+        min_x = std::min(min_x, point.x);
+        min_y = std::min(min_y, point.y);
+        max_x = std::max(max_x, point.x);
+        max_y = std::max(max_y, point.y);
+    }
+    return Rect { min_x, min_y, max_x - min_x, max_y - min_y };
+}
+
+Rect merge(const Rect& left, const Rect& right)
+{
+    const double min_x = std::min(left.x, right.x);
+    const double min_y = std::min(left.y, right.y);
+    const double max_x = std::max(left.x + left.width, right.x + right.width);
+    const double max_y = std::max(left.y + left.height, right.y + right.height);
+    return Rect { min_x, min_y, max_x - min_x, max_y - min_y };
+}
+
+Polygon translate(const Polygon& polygon, double x, double y)
+{
+    Polygon translated;
+    translated.reserve(polygon.size());
+    for (const Point& point : polygon)
+    {
+        translated.push_back(Point { point.x + x, point.y + y });
+    }
+    return translated;
+}
+
+std::vector<Rect> merge_rects(const std::vector<Rect>& rects)
+{
+    std::vector<double> xs;
+    std::vector<double> ys;
+    xs.reserve(rects.size() * 2);
+    ys.reserve(rects.size() * 2);
+    for (const Rect& rect : rects)
+    {
+        xs.push_back(rect.x);
+        xs.push_back(rect.x + rect.width);
+        ys.push_back(rect.y);
+        ys.push_back(rect.y + rect.height);
+    }
+    std::sort(xs.begin(), xs.end());
+    xs.erase(std::unique(xs.begin(), xs.end()), xs.end());
+    std::sort(ys.begin(), ys.end());
+    ys.erase(std::unique(ys.begin(), ys.end()), ys.end());
+    if (xs.size() < 2 || ys.size() < 2)
+    {
+        return {};
+    }
+
+    const size_t columns = xs.size() - 1;
+    const size_t rows = ys.size() - 1;
+    std::vector<bool> covered(columns * rows);
+    for (const Rect& rect : rects)
+    {
+        const size_t left = coordinate_index(xs, rect.x);
+        const size_t right = coordinate_index(xs, rect.x + rect.width);
+        const size_t top = coordinate_index(ys, rect.y);
+        const size_t bottom = coordinate_index(ys, rect.y + rect.height);
+        for (size_t row = top; row < bottom; row++)
+        {
+            std::fill(covered.begin() + row * columns + left,
+                covered.begin() + row * columns + right, true);
+        }
+    }
+
+    std::vector<Rect> merged;
+    for (size_t row = 0; row < rows; row++)
+    {
+        for (size_t column = 0; column < columns; column++)
+        {
+            if (!covered[row * columns + column])
+            {
+                continue;
+            }
+            size_t right = column + 1;
+            while (right < columns && covered[row * columns + right])
+            {
+                right++;
+            }
+            size_t bottom = row + 1;
+            while (bottom < rows
+                && std::all_of(covered.begin() + bottom * columns + column,
+                    covered.begin() + bottom * columns + right,
+                    [](bool cell) { return cell; }))
+            {
+                bottom++;
+            }
+            for (size_t merged_row = row; merged_row < bottom; merged_row++)
+            {
+                std::fill(covered.begin() + merged_row * columns + column,
+                    covered.begin() + merged_row * columns + right, false);
+            }
+            merged.push_back(Rect {
+                xs[column], ys[row], xs[right] - xs[column], ys[bottom] - ys[row] });
+        }
+    }
+    return merged;
+}
+
+vili::node coordinate_to_vili(double value)
+{
+    if (value == std::floor(value) && std::abs(value) < 1e15)
+    {
+        return static_cast<vili::integer>(value);
+    }
+    return value;
+}
+
+Polygon polygon_from_vili(const vili::node& points)
+{
+    Polygon polygon;
+    polygon.reserve(points.size());
+    for (const vili::node& point : points)
+    {
+        polygon.push_back(point_from_vili(point));
+    }
+    return polygon;
+}
+
+vili::node polygon_to_vili(const Polygon& polygon)
+{
+    vili::array points;
+    points.reserve(polygon.size());
+    for (const Point& point : polygon)
+    {
+        points.push_back(point_to_vili(point));
+    }
+    return points;
+}
+
+Polygon simplify_polygon(const Polygon& polygon, double tolerance)
+{
+    if (tolerance <= 0 || polygon.size() <= 3)
+    {
+        return polygon;
+    }
+    // The outline is split in two chains at the point farthest from the first one
+    size_t farthest = 0;
+    double max_distance = 0;
+    for (size_t index = 1; index < polygon.size(); index++)
+    {
+        const double distance = std::hypot(
+            polygon[index].x - polygon[0].x, polygon[index].y - polygon[0].y);
+        if (distance > max_distance)
+        {
+            max_distance = distance;
+            farthest = index;
+        }
+    }
+    if (farthest == 0)
+    {
+        return polygon;
+    }
+    Polygon simplified;
+    simplify_chain(polygon, 0, farthest, tolerance, simplified);
+    simplify_chain(polygon, farthest, polygon.size(), tolerance, simplified);
+    return (simplified.size() >= 3) ? simplified : polygon;
+}
+
+bool is_convex(const Polygon& polygon)
+{
+    bool has_positive = false;
+    bool has_negative = false;
+    for (size_t index = 0; index < polygon.size(); index++)
+    {
+        const double turn = cross(polygon[index], polygon[(index + 1) % polygon.size()],
+            polygon[(index + 2) % polygon.size()]);
+        has_positive = has_positive || turn > 0;
+        has_negative = has_negative || turn < 0;
+    }
+    return !(has_positive && has_negative);
+}
+
+std::vector<Polygon> convex_decomposition(const Polygon& polygon)
+{
+    if (polygon.size() <= 3 || is_convex(polygon))
+    {
+        return { polygon };
+    }
+    Polygon outline = polygon;
+    if (signed_area(outline) < 0)
+    {
+        std::reverse(outline.begin(), outline.end());
+    }
+    std::vector<std::vector<size_t>> parts = triangulate(outline);
+    if (parts.empty())
+    {
+        return { polygon };
+    }
+
+    // Hertel-Mehlhorn : removes every diagonal that keeps both sides convex
+    bool merged_any = true;
+    while (merged_any)
+    {
+        merged_any = false;
+        for (size_t part = 0; part < parts.size() && !merged_any; part++)
+        {
+            for (size_t other = part + 1; other < parts.size() && !merged_any; other++)
+            {
+                std::vector<size_t> merged = merge_parts(parts[part], parts[other]);
+                if (!merged.empty() && is_convex(part_polygon(outline, merged)))
+                {
+                    parts[part] = std::move(merged);
+                    parts.erase(parts.begin() + other);
+                    merged_any = true;
+                }
+            }
+        }
+    }
+
+    std::vector<Polygon> convex_parts;
+    convex_parts.reserve(parts.size());
+    for (const std::vector<size_t>& part : parts)
+    {
+        convex_parts.push_back(part_polygon(outline, part));
+    }
+    return convex_parts;
+}
+
+Shape make_ellipse_shape(const Rect& bounds)
+{
+    Shape shape;
+    const double center_x = bounds.x + bounds.width / 2;
+    const double center_y = bounds.y + bounds.height / 2;
+    shape.type = (bounds.width == bounds.height) ? ShapeType::Circle : ShapeType::Capsule;
+    shape.radius = std::min(bounds.width, bounds.height) / 2;
+    if (bounds.width >= bounds.height)
+    {
+        shape.start = Point { bounds.x + shape.radius, center_y };
+        shape.end = Point { bounds.x + bounds.width - shape.radius, center_y };
+    }
+    else
+    {
+        shape.start = Point { center_x, bounds.y + shape.radius };
+        shape.end = Point { center_x, bounds.y + bounds.height - shape.radius };
+    }
+    return shape;
+}
+
+Shape make_box_shape(const Rect& box)
+{
+    Shape shape;
+    shape.type = ShapeType::Box;
+    shape.box = box;
+    return shape;
+}
+
+Rect shape_bounds(const Shape& shape)
+{
+    switch (shape.type)
+    {
+    case ShapeType::Box:
+        return shape.box;
+    case ShapeType::Circle:
+    case ShapeType::Capsule:
+    {
+        const double min_x = std::min(shape.start.x, shape.end.x) - shape.radius;
+        const double min_y = std::min(shape.start.y, shape.end.y) - shape.radius;
+        const double max_x = std::max(shape.start.x, shape.end.x) + shape.radius;
+        const double max_y = std::max(shape.start.y, shape.end.y) + shape.radius;
+        return Rect { min_x, min_y, max_x - min_x, max_y - min_y };
+    }
+    default:
+        return bounding_rect(shape.points);
+    }
+}
+
+bool as_rect(const Shape& shape, Rect& rect)
+{
+    if (shape.type == ShapeType::Box)
+    {
+        rect = shape.box;
+        return true;
+    }
+    return shape.type == ShapeType::Polygon && as_rect(shape.points, rect);
+}
+
+bool overlaps(const Shape& shape, const Rect& rect)
+{
+    const Rect bounds = shape_bounds(shape);
+    if (bounds.x >= rect.x + rect.width || rect.x >= bounds.x + bounds.width
+        || bounds.y >= rect.y + rect.height || rect.y >= bounds.y + bounds.height)
+    {
+        return false;
+    }
+    switch (shape.type)
+    {
+    case ShapeType::Box:
+        return shape.box.width > 0 && shape.box.height > 0;
+    case ShapeType::Circle:
+    case ShapeType::Capsule:
+    {
+        if (segment_intersects_rect(shape.start, shape.end, rect))
+        {
+            return shape.radius > 0;
+        }
+        double distance = std::min(
+            distance_to_rect(shape.start, rect), distance_to_rect(shape.end, rect));
+        for (const Point& corner : to_polygon(rect))
+        {
+            distance = std::min(
+                distance, distance_to_segment(corner, shape.start, shape.end));
+        }
+        return distance < shape.radius;
+    }
+    default:
+        return std::abs(signed_area(clip_polygon(shape.points, rect))) > 1e-9;
+    }
+}
+
+Shape translate(const Shape& shape, double x, double y)
+{
+    Shape translated = shape;
+    translated.points = translate(shape.points, x, y);
+    translated.box.x += x;
+    translated.box.y += y;
+    translated.start = Point { shape.start.x + x, shape.start.y + y };
+    translated.end = Point { shape.end.x + x, shape.end.y + y };
+    return translated;
+}
+
+Shape shape_from_vili(const vili::node& collision)
+{
+    Shape shape;
+    if (collision.contains("box"))
+    {
+        const vili::node& box = collision.at("box");
+        return make_box_shape(Rect { box.at("x").as<vili::number>(),
+            box.at("y").as<vili::number>(), box.at("width").as<vili::number>(),
+            box.at("height").as<vili::number>() });
+    }
+    if (collision.contains("circle"))
+    {
+        const vili::node& circle = collision.at("circle");
+        shape.type = ShapeType::Circle;
+        shape.start = point_from_vili(circle);
+        shape.end = shape.start;
+        shape.radius = circle.at("radius").as<vili::number>();
+        return shape;
+    }
+    if (collision.contains("capsule"))
+    {
+        const vili::node& capsule = collision.at("capsule");
+        shape.type = ShapeType::Capsule;
+        shape.start = point_from_vili(capsule.at("start"));
+        shape.end = point_from_vili(capsule.at("end"));
+        shape.radius = capsule.at("radius").as<vili::number>();
+        return shape;
+    }
+    shape.points = polygon_from_vili(collision.at("points"));
+    return shape;
+}
+
+void shape_to_vili(const Shape& shape, vili::node& collision)
+{
+    switch (shape.type)
+    {
+    case ShapeType::Box:
+        collision["box"] = vili::make_object("x", coordinate_to_vili(shape.box.x), "y",
+            coordinate_to_vili(shape.box.y), "width", coordinate_to_vili(shape.box.width),
+            "height", coordinate_to_vili(shape.box.height));
+        break;
+    case ShapeType::Circle:
+        collision["circle"] = point_to_vili(shape.start);
+        collision["circle"]["radius"] = coordinate_to_vili(shape.radius);
+        break;
+    case ShapeType::Capsule:
+        collision["capsule"] = vili::make_object("start", point_to_vili(shape.start),
+            "end", point_to_vili(shape.end), "radius", coordinate_to_vili(shape.radius));
+        break;
+    default:
+        collision["points"] = polygon_to_vili(shape.points);
+        break;
+    }
+}
+
+Shape flip_shape(const Shape& shape, double width, double height, bool horizontal,
+    bool vertical, bool diagonal)
+{
+    const double flipped_width = diagonal ? height : width;
+    const double flipped_height = diagonal ? width : height;
+    const auto flip_point = [&](const Point& point)
+    {
+        Point flipped = diagonal ? Point { point.y, point.x } : point;
+        flipped.x = horizontal ? flipped_width - flipped.x : flipped.x;
+        flipped.y = vertical ? flipped_height - flipped.y : flipped.y;
+        return flipped;
+    };
+
+    Shape flipped = shape;
+    for (Point& point : flipped.points)
+    {
+        point = flip_point(point);
+    }
+    // Each mirroring reverses the winding order
+    if ((diagonal + horizontal + vertical) % 2)
+    {
+        std::reverse(flipped.points.begin(), flipped.points.end());
+    }
+    flipped.start = flip_point(shape.start);
+    flipped.end = flip_point(shape.end);
+    if (shape.type == ShapeType::Box)
+    {
+        const Point corner = flip_point(Point { shape.box.x, shape.box.y });
+        const Point opposite = flip_point(
+            Point { shape.box.x + shape.box.width, shape.box.y + shape.box.height });
+        flipped.box
+            = Rect { std::min(corner.x, opposite.x), std::min(corner.y, opposite.y),
+                  std::abs(opposite.x - corner.x), std::abs(opposite.y - corner.y) };
+    }
+    return flipped;
+}
@@ -18,11 +18,11 @@ std::shared_ptr<spdlog::logger> logger;
 
 void init_logger()
 {
-    auto dist_sink = std::make_shared<spdlog::sinks::dist_sink_st>();
+    auto dist_sink = std::make_shared<spdlog::sinks::dist_sink_mt>();
 
-    const auto sink1 = std::make_shared<spdlog::sinks::stdout_color_sink_st>();
+    const auto sink1 = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
     const auto sink2
-        = std::make_shared<spdlog::sinks::basic_file_sink_st>("debug.log");
+        = std::make_shared<spdlog::sinks::basic_file_sink_mt>("debug.log");
 
     dist_sink->add_sink(sink1);
     dist_sink->add_sink(sink2);
@@ -1,13 +1,30 @@
 #include <algorithm>
+#include <atomic>
 #include <filesystem>
 #include <fstream>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include <collision_bvh.hpp>
+#include <collision_shapes.hpp>
+#include <geometry.hpp>
 #include <logger.hpp>
+#include <navigation.hpp>
+#include <object_columns.hpp>
+#include <object_index.hpp>
+#include <regions.hpp>
+#include <render_batches.hpp>
+#include <tile_chunks.hpp>
+#include <tile_collisions.hpp>
+#include <tile_encoding.hpp>
+#include <tiles_sidecar.hpp>
+#include <tilesets.hpp>
 #include <lyra/arguments.hpp>
 #include <lyra/lyra.hpp>
 #include <nlohmann/json.hpp>
+#include <vili/binary.hpp>
 #include <vili/node.hpp>
 #include <vili/writer.hpp>
 
@@ -16,6 +33,25 @@ struct TiledIntegrationArgs
     std::string input_file;
     std::string output_file;
     std::string cwd;
+    std::string format = "text";
+    bool tiles_sidecar = false;
+    std::string tile_encoding = "dense";
+    unsigned int chunk_size = 0;
+    bool render_batches = false;
+    bool tile_rects = false;
+    bool tileset_index = false;
+    bool bake_collisions = false;
+    bool collision_grid = false;
+    unsigned int navigation_cluster_size = 0;
+    double simplify_tolerance = 0;
+    bool convex_collisions = false;
+    bool collision_bvh = false;
+    bool share_collision_shapes = false;
+    bool analytic_shapes = false;
+    std::string object_index;
+    bool columnar_objects = false;
+    bool split_tile_flags = false;
+    std::string split_regions;
 };
 
 std::string normalize_path(std::string path)
@@ -97,7 +133,7 @@ void repeat_sprites(vili::node& sprites, const std::string& base_id,
             new_sprite["rect"]["x"] = new_x;
             new_sprite["rect"]["y"] = new_y;
 
-            sprites[base_id + "_" + std::to_string(id)] = new_sprite;
+            sprites[base_id + "_" + std::to_string(id)] = std::move(new_sprite);
             id++;
         }
     }
@@ -106,12 +142,14 @@ void repeat_sprites(vili::node& sprites, const std::string& base_id,
 vili::node create_game_object(const nlohmann::json::value_type& object, const std::unordered_map<uint32_t, std::string>& objects_ids)
 {
     const std::string object_type = object.at("type").get<std::string>();
-    vili::node game_object = vili::object { { "type", object_type } };
-    game_object["Requires"]
-        = vili::object{ { "x", object.at("x").get<float>() },
-              { "y", object.at("y").get<float>() }, {"width", object.at("width").get<float>()}, {"height", object.at("height").get<float>()}, {"rotation", object.at("rotation").get<float>() } };
+    vili::node game_object = vili::make_object("type", object_type, "Requires",
+        vili::make_object("x", object.at("x").get<float>(), "y",
+            object.at("y").get<float>(), "width", object.at("width").get<float>(),
+            "height", object.at("height").get<float>(), "rotation",
+            object.at("rotation").get<float>()));
     if (object.contains("properties"))
     {
+        game_object["Requires"].reserve(5 + object["properties"].size());
         for (const auto& object_property : object["properties"])
         {
             const std::string property_type = object_property["type"];
@@ -176,8 +214,19 @@ std::string make_object_id(const std::string& base_id, uint32_t amount_of_object
     return replace(base_id, "{index}", std::to_string(amount_of_objects));
 }
 
+/**
+ * \brief Box, circle or capsule (for ellipses) shape of a Tiled object
+ */
+Shape make_object_shape(const nlohmann::json& object)
+{
+    const Rect bounds { object.at("x").get<double>(), object.at("y").get<double>(),
+        object.at("width").get<double>(), object.at("height").get<double>() };
+    const bool ellipse = object.contains("ellipse") && object.at("ellipse").get<bool>();
+    return ellipse ? make_ellipse_shape(bounds) : make_box_shape(bounds);
+}
+
 vili::object export_obe_scene(
-    const std::string& base_folder, const std::string& scene_folder, const std::string& vili_filename, nlohmann::json::object_t tmx_json)
+    const std::string& base_folder, const std::string& scene_folder, const std::string& vili_filename, nlohmann::json::object_t tmx_json, bool analytic_shapes)
 {
     std::string scene_name = vili_filename;
     auto last_slash = scene_name.find_last_of("/");
@@ -223,11 +272,12 @@ vili::object export_obe_scene(
         {
             std::string layer_id = tmx_layer["name"];
             layer_id = vili::utils::string::replace(layer_id, " ", "_");
-            std::vector<int> layer_data = tmx_layer["data"];
+            std::vector<uint32_t> layer_data = tmx_layer["data"];
             vili::array tiles_data = vili::array {};
+            tiles_data.reserve(layer_data.size());
             for (const uint32_t tile : layer_data)
             {
-                tiles_data.push_back(vili::integer{ tile });
+                tiles_data.emplace_back(vili::integer { tile });
             }
             obe_scene["Tiles"]["layers"][layer_id] = vili::object {};
             vili::node& obe_layer = obe_scene["Tiles"]["layers"][layer_id];
@@ -239,10 +289,13 @@ vili::object export_obe_scene(
             obe_layer["layer"] = custom_layer ? custom_layer.value() : layer--;
             obe_layer["visible"] = tmx_layer["visible"].get<bool>();
             obe_layer["opacity"] = tmx_layer["opacity"].get<int>();
-            obe_layer["tiles"] = tiles_data;
+            obe_layer["tiles"] = std::move(tiles_data);
         }
         else if (tmx_layer["type"] == "objectgroup")
         {
+            const size_t objects_amount = tmx_layer["objects"].size();
+            game_objects.reserve(game_objects.size() + objects_amount);
+            collisions.reserve(collisions.size() + objects_amount);
             for (const auto& object : tmx_layer["objects"])
             {
                 if (object.contains("type") && !object.at("type").get<std::string>().empty())
@@ -255,28 +308,41 @@ vili::object export_obe_scene(
                 }
                 else if (object.contains("polygon"))
                 {
-                    vili::node new_collision = vili::object {};
-                    new_collision["points"] = vili::array {};
                     const int x = object.at("x");
                     const int y = object.at("y");
-                    for (const auto& tmx_collision_point : object.at("polygon"))
+                    const auto& tmx_polygon = object.at("polygon");
+                    vili::node collision_points = vili::array {};
+                    collision_points.reserve(tmx_polygon.size());
+                    for (const auto& tmx_collision_point : tmx_polygon)
                     {
-                        new_collision["points"].push(vili::object {
-                            { "x", tmx_collision_point.at("x").get<int>() + x },
-                            { "y", tmx_collision_point.at("y").get<int>() + y } });
+                        collision_points.push(vili::make_object("x",
+                            tmx_collision_point.at("x").get<int>() + x, "y",
+                            tmx_collision_point.at("y").get<int>() + y));
                     }
-                    new_collision["unit"] = "ScenePixels";
+                    vili::node new_collision = vili::make_object(
+                        "points", std::move(collision_points), "unit", "ScenePixels");
                     std::string collision_id = object.at("name").get<std::string>();
                     if (collision_id.empty())
                     {
                         collision_id
                             = "collider_" + std::to_string(object.at("id").get<int>());
                     }
-                    collisions[collision_id] = new_collision;
+                    collisions[collision_id] = std::move(new_collision);
                 }
-                else
+                else if (analytic_shapes && !object.contains("point")
+                    && object.at("width").get<double>() > 0
+                    && object.at("height").get<double>() > 0)
                 {
-                    
+                    vili::node new_collision = vili::object {};
+                    shape_to_vili(make_object_shape(object), new_collision);
+                    new_collision["unit"] = "ScenePixels";
+                    std::string collision_id = object.at("name").get<std::string>();
+                    if (collision_id.empty())
+                    {
+                        collision_id
+                            = "collider_" + std::to_string(object.at("id").get<int>());
+                    }
+                    collisions[collision_id] = std::move(new_collision);
                 }
             }
         }
@@ -318,18 +384,18 @@ vili::object export_obe_scene(
                     find_property<int>(sprite_properties, "repeat_y"));
             }
 
-            sprites[sprite_id] = new_sprite;
+            sprites[sprite_id] = std::move(new_sprite);
         }
     }
 
     if (!sprites.empty())
     {
-        obe_scene["Sprites"] = sprites;
+        obe_scene["Sprites"] = std::move(sprites);
     }
 
     if (!collisions.empty())
     {
-        obe_scene["Collisions"] = collisions;
+        obe_scene["Collisions"] = std::move(collisions);
     }
 
     obe_scene["Tiles"]["sources"] = vili::object {};
@@ -357,14 +423,34 @@ vili::object export_obe_scene(
         std::filesystem::path tileset_directory = std::filesystem::canonical(
             std::filesystem::path(scene_folder) / tileset_source)
                                 .remove_filename();
-        std::string image_path = tileset_json["image"].get<std::string>();
-        image_path = (tileset_directory / image_path).string();
-        image_path = std::filesystem::relative(image_path, base_folder).string();
-        image_path = replace(image_path, "\\", "/");
-        vili_tileset["image"]
-            = vili::object { { "width", tileset_json["imagewidth"].get<int>() },
-                  { "height", tileset_json["imageheight"].get<int>() },
-                  { "path", image_path } };
+        const auto make_image = [&](const nlohmann::json& tmx_image)
+        {
+            std::string image_path = tmx_image["image"].get<std::string>();
+            image_path = (tileset_directory / image_path).string();
+            image_path = std::filesystem::relative(image_path, base_folder).string();
+            image_path = replace(image_path, "\\", "/");
+            return vili::object { { "width", tmx_image["imagewidth"].get<int>() },
+                { "height", tmx_image["imageheight"].get<int>() }, { "path", image_path } };
+        };
+        if (tileset_json.count("image"))
+        {
+            vili_tileset["image"] = make_image(tileset_json);
+        }
+        else
+        {
+            // Collection of images, every tile has its own image
+            vili::node images = vili::array {};
+            for (const auto& tmx_tile : tileset_json["tiles"])
+            {
+                if (tmx_tile.contains("image"))
+                {
+                    vili::node image = make_image(tmx_tile);
+                    image["id"] = tmx_tile.at("id").get<int>();
+                    images.push(std::move(image));
+                }
+            }
+            vili_tileset["images"] = std::move(images);
+        }
 
         vili::node tileset_collisions = vili::array {};
         vili::node animated_tiles = vili::array {};
@@ -382,9 +468,9 @@ vili::object export_obe_scene(
                         { "clock", tile_animation_frame.at("duration").get<int>() },
                         { "tileid", tile_animation_frame.at("tileid").get<int>() }
                     };
-                    new_animated_tile["frames"].push(new_animation_frame);
+                    new_animated_tile["frames"].push(std::move(new_animation_frame));
                 }
-                animated_tiles.push(new_animated_tile);
+                animated_tiles.push(std::move(new_animated_tile));
             }
             if (tmx_tile.contains("objectgroup"))
             {
@@ -400,28 +486,31 @@ vili::object export_obe_scene(
                         {
                             const int x = object.at("x");
                             const int y = object.at("y");
-                            for (const auto& tmx_collision_point : object.at("polygon"))
+                            const auto& tmx_polygon = object.at("polygon");
+                            collision_points.reserve(tmx_polygon.size());
+                            for (const auto& tmx_collision_point : tmx_polygon)
                             {
-                                collision_points.push(vili::object {
-                                    { "x", tmx_collision_point.at("x").get<int>() + x },
-                                    { "y",
-                                        tmx_collision_point.at("y").get<int>() + y } });
+                                collision_points.push(vili::make_object("x",
+                                    tmx_collision_point.at("x").get<int>() + x, "y",
+                                    tmx_collision_point.at("y").get<int>() + y));
                             }
                         }
+                        else if (analytic_shapes)
+                        {
+                            new_collision.erase("points");
+                            shape_to_vili(make_object_shape(object), new_collision);
+                        }
                         else if (!object.contains("point"))
                         {
                             const int x = object.at("x");
                             const int y = object.at("y");
                             const int width = object.at("width");
                             const int height = object.at("height");
-                            collision_points.push(
-                                vili::object { { "x", x }, { "y", y } });
-                            collision_points.push(
-                                vili::object { { "x", x + width }, { "y", y } });
-                            collision_points.push(
-                                vili::object { { "x", x + width }, { "y", y + height } });
-                            collision_points.push(
-                                vili::object { { "x", x }, { "y", y + height } });
+                            collision_points = vili::make_array(
+                                vili::make_object("x", x, "y", y),
+                                vili::make_object("x", x + width, "y", y),
+                                vili::make_object("x", x + width, "y", y + height),
+                                vili::make_object("x", x, "y", y + height));
                         }
                         if (object.contains("properties"))
                         {
@@ -433,7 +522,7 @@ vili::object export_obe_scene(
                             }
                         }
                         new_collision["unit"] = "ScenePixels";
-                        tileset_collisions.push(new_collision);
+                        tileset_collisions.push(std::move(new_collision));
                     }
                     else if (object.contains("point") && object.at("point").get<bool>())
                     {
@@ -444,7 +533,7 @@ vili::object export_obe_scene(
                             = create_game_object(object, objects_ids);
                         new_game_object["tileId"] = vili::integer { object_id };
                         new_game_object["id"] = game_object_id;
-                        tilesets_game_objects.push(new_game_object);
+                        tilesets_game_objects.push(std::move(new_game_object));
                     }
                 }
             }
@@ -452,48 +541,371 @@ vili::object export_obe_scene(
 
         if (!animated_tiles.empty())
         {
-            vili_tileset["animations"] = animated_tiles;
+            vili_tileset["animations"] = std::move(animated_tiles);
         }
 
         if (!tileset_collisions.empty())
         {
-            vili_tileset["collisions"] = tileset_collisions;
+            vili_tileset["collisions"] = std::move(tileset_collisions);
         }
 
         if (!tilesets_game_objects.empty())
         {
-            vili_tileset["objects"] = tilesets_game_objects;
+            vili_tileset["objects"] = std::move(tilesets_game_objects);
         }
     }
 
     if (!game_objects.empty())
     {
-        obe_scene["GameObjects"] = game_objects;
+        obe_scene["GameObjects"] = std::move(game_objects);
     }
 
     return obe_scene;
 }
 
+/**
+ * \brief Path of a file written by the conversion, relative to the working directory
+ */
+std::string make_file_reference(const std::filesystem::path& path, const std::string& cwd)
+{
+    // The file may not exist yet, only its folder can be made relative
+    const std::filesystem::path absolute_path = std::filesystem::absolute(path);
+    return (std::filesystem::relative(absolute_path.parent_path(), cwd)
+        / absolute_path.filename())
+        .lexically_normal()
+        .generic_string();
+}
+
+/**
+ * \brief Inserts a suffix after the scene name of a path (world.map.vili -> world_x0_y0.map.vili)
+ */
+std::string make_sibling_path(const std::string& output_file, const std::string& suffix,
+    const std::string& extension = "")
+{
+    const std::filesystem::path path(output_file);
+    const std::string filename = path.filename().string();
+    const size_t first_dot = filename.find('.');
+    const std::string scene_name = filename.substr(0, first_dot);
+    const std::string extensions
+        = extension.empty() ? filename.substr(std::min(first_dot, filename.size())) : extension;
+    return (path.parent_path() / (scene_name + suffix + extensions)).string();
+}
+
+void write_vili_file(const vili::node& data, const std::string& output_file,
+    const TiledIntegrationArgs& args, unsigned int items_per_line)
+{
+    std::string dump;
+    if (args.format == "binary")
+    {
+        dump = vili::binary::dump(data);
+    }
+    else
+    {
+        vili::writer::dump_options options;
+        options.array.items_per_line.any = items_per_line;
+        options.object.items_per_line.any = 1;
+        dump = vili::writer::dump(data, options);
+    }
+    std::ofstream file;
+    file.open(output_file,
+        (args.format == "binary") ? std::ios::out | std::ios::binary : std::ios::out);
+    file.write(dump.c_str(), dump.size());
+    file.close();
+}
+
+/**
+ * \brief Applies the tile output options to a scene then writes it
+ */
+void write_scene(vili::object& obe_scene, const std::string& output_file,
+    const std::vector<Tileset>& tilesets, const TiledIntegrationArgs& args)
+{
+    if (args.tileset_index)
+    {
+        add_tileset_usage(obe_scene["Tiles"], tilesets);
+    }
+    if (args.bake_collisions)
+    {
+        const CollisionBakingStats stats = bake_tile_collisions(obe_scene, tilesets);
+        logger->info("  - {} : baked {} tile collision shapes in {} colliders", output_file,
+            stats.tile_shapes, stats.colliders);
+    }
+    if (args.collision_grid)
+    {
+        obe_scene["Tiles"]["collisionGrid"]
+            = make_collision_grid(obe_scene["Tiles"], tilesets);
+    }
+    if (args.navigation_cluster_size)
+    {
+        // Baked tile collisions are already part of the scene colliders
+        vili::node navigation = make_navigation(
+            obe_scene, tilesets, args.navigation_cluster_size, !args.bake_collisions);
+        if (!navigation.is_null())
+        {
+            logger->info("  - {} : navigation graph of {} nodes and {} edges",
+                output_file, navigation.at("nodes").size(), navigation.at("edges").size());
+            obe_scene["Navigation"] = std::move(navigation);
+        }
+    }
+    if (args.chunk_size)
+    {
+        chunk_tile_layers(obe_scene["Tiles"], args.chunk_size);
+    }
+    if (args.render_batches)
+    {
+        const std::filesystem::path batches_path
+            = std::filesystem::absolute(output_file).replace_extension(".batches");
+        write_render_batches(obe_scene["Tiles"], tilesets, batches_path.string(),
+            make_file_reference(batches_path, args.cwd));
+    }
+    if (args.split_tile_flags)
+    {
+        const size_t flipped_tiles = split_tile_flags(obe_scene["Tiles"]);
+        logger->info(
+            "  - {} : moved the flip flags of {} tiles", output_file, flipped_tiles);
+    }
+    if (args.tile_encoding == "auto")
+    {
+        for (const TileLayerStats& layer : encode_tile_layers(obe_scene["Tiles"]))
+        {
+            logger->info("  - {} / {} : {} ({} -> {} bytes, entropy {:.2f} bits/tile)",
+                output_file, layer.layer_id, to_string(layer), layer.dense_size,
+                layer.encoded_size, layer.entropy);
+        }
+    }
+    if (args.tiles_sidecar)
+    {
+        const std::filesystem::path sidecar_path
+            = std::filesystem::absolute(output_file).replace_extension(".tiles");
+        write_tiles_sidecar(obe_scene["Tiles"], sidecar_path.string(),
+            make_file_reference(sidecar_path, args.cwd));
+    }
+    if (args.collision_bvh)
+    {
+        vili::node bvh = make_collision_bvh(obe_scene);
+        if (!bvh.is_null())
+        {
+            obe_scene["CollisionBvh"] = std::move(bvh);
+        }
+    }
+    if (!args.object_index.empty())
+    {
+        const double cell_size = parse_object_index_cell_size(args.object_index);
+        vili::node index = make_object_index(obe_scene, cell_size);
+        if (!index.is_null())
+        {
+            logger->info("  - {} : indexed {} GameObjects in {} x {} cells of {} pixels",
+                output_file, index.at("objects").size(), index.at("columns").as_integer(),
+                index.at("rows").as_integer(), index.at("cellSize").dump());
+            obe_scene["GameObjectsIndex"] = std::move(index);
+        }
+    }
+    if (args.columnar_objects)
+    {
+        // After the object index, which reads the objects one by one
+        const size_t groups = make_object_columns(obe_scene);
+        logger->info(
+            "  - {} : GameObjects stored in {} type columns", output_file, groups);
+    }
+    if (args.share_collision_shapes)
+    {
+        ShapeLibrary library;
+        if (obe_scene.find("Collisions") != obe_scene.end())
+        {
+            library.instance_colliders(obe_scene["Collisions"]);
+        }
+        if (obe_scene["Tiles"].contains("sources"))
+        {
+            library.instance_tileset_collisions(obe_scene["Tiles"]["sources"]);
+        }
+        if (library.size())
+        {
+            obe_scene["CollisionShapes"] = library.shapes();
+            logger->info("  - {} : {} collisions share {} shapes", output_file,
+                library.instances(), library.size());
+        }
+    }
+    write_vili_file(obe_scene, output_file, args,
+        args.chunk_size ? args.chunk_size : obe_scene["Tiles"]["width"].as<vili::integer>());
+}
+
+/**
+ * \brief Writes one scene per region, the shared tilesets and the regions index
+ */
+void write_regions(vili::object& obe_scene, const std::vector<Tileset>& tilesets,
+    const TiledIntegrationArgs& args)
+{
+    unsigned int region_width = 0;
+    unsigned int region_height = 0;
+    parse_region_size(args.split_regions, region_width, region_height);
+    RegionGrid grid = split_regions(obe_scene, region_width, region_height);
+
+    const std::string tilesets_file = make_sibling_path(args.output_file, "", ".tilesets.vili");
+    const std::string tilesets_reference = make_file_reference(tilesets_file, args.cwd);
+    vili::node sources = vili::object {};
+    if (obe_scene["Tiles"].contains("sources"))
+    {
+        sources["sources"] = std::move(obe_scene["Tiles"]["sources"]);
+    }
+    if (obe_scene["Tiles"].contains("sourceIndex"))
+    {
+        sources["sourceIndex"] = std::move(obe_scene["Tiles"]["sourceIndex"]);
+    }
+    if (args.share_collision_shapes && sources.contains("sources"))
+    {
+        ShapeLibrary library;
+        library.instance_tileset_collisions(sources["sources"]);
+        if (library.size())
+        {
+            sources["CollisionShapes"] = library.shapes();
+        }
+    }
+    write_vili_file(sources, tilesets_file, args, 1);
+
+    std::vector<std::string> region_files;
+    std::vector<std::string> region_references;
+    for (Region& region : grid.regions)
+    {
+        region.scene["Tiles"]["sourcesFile"] = tilesets_reference;
+        region_files.push_back(make_sibling_path(args.output_file, "_" + region.id));
+        region_references.push_back(make_file_reference(region_files.back(), args.cwd));
+    }
+
+    // Regions are independent, each worker converts the next region left
+    std::atomic<size_t> next_region = 0;
+    std::mutex error_mutex;
+    std::exception_ptr error;
+    const auto convert_regions = [&]()
+    {
+        for (size_t index = next_region++; index < grid.regions.size(); index = next_region++)
+        {
+            try
+            {
+                write_scene(grid.regions[index].scene, region_files[index], tilesets, args);
+            }
+            catch (...)
+            {
+                const std::lock_guard<std::mutex> lock(error_mutex);
+                error = error ? error : std::current_exception();
+            }
+        }
+    };
+    const size_t workers_amount = std::min<size_t>(
+        std::max(1u, std::thread::hardware_concurrency()), grid.regions.size());
+    std::vector<std::thread> workers;
+    for (size_t worker = 1; worker < workers_amount; worker++)
+    {
+        workers.emplace_back(convert_regions);
+    }
+    convert_regions();
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+
+    const std::string index_file = make_sibling_path(args.output_file, "", ".regions.vili");
+    vili::node index = vili::object {};
+    index["Regions"] = make_regions_index(grid, obe_scene, region_references, tilesets_reference);
+    write_vili_file(index, index_file, args, 8);
+    logger->info("  - Regions : {} ({}x{} regions of {}x{} tiles)", index_file, grid.columns,
+        grid.rows, region_width, region_height);
+}
+
 void run(const TiledIntegrationArgs& args)
 {
     const std::string scene_folder = std::filesystem::path(args.input_file).parent_path().string();
     vili::object obe_scene = export_obe_scene(
-        args.cwd, scene_folder, args.output_file, load_tiled_map(args.input_file));
-    vili::writer::dump_options options;
-    options.array.items_per_line.any = obe_scene["Tiles"]["width"];
-    options.object.items_per_line.any = 1;
-    std::string scene_dump = vili::writer::dump(obe_scene, options);
-    std::ofstream scene_file;
-    scene_file.open(args.output_file);
-    scene_file.write(scene_dump.c_str(), scene_dump.size());
-    scene_file.close();
+        args.cwd, scene_folder, args.output_file, load_tiled_map(args.input_file),
+        args.analytic_shapes);
+    if (args.simplify_tolerance > 0 || args.convex_collisions)
+    {
+        const CollisionShapeStats stats = optimize_collision_shapes(
+            obe_scene, args.simplify_tolerance, args.convex_collisions);
+        logger->info("  - Collision shapes : {} shapes, {} -> {} points, {} concave shapes "
+                     "split in {} convex parts",
+            stats.shapes, stats.points_before, stats.points_after, stats.concave_shapes,
+            stats.convex_parts);
+    }
+    // Loaded before region splitting, which moves the sources to their own file
+    const std::vector<Tileset> tilesets = load_tilesets(obe_scene["Tiles"]["sources"]);
+    if (args.tile_rects)
+    {
+        add_tile_rect_tables(obe_scene["Tiles"]["sources"], tilesets);
+    }
+    if (args.tileset_index)
+    {
+        obe_scene["Tiles"]["sourceIndex"] = make_source_index(tilesets);
+    }
+    if (args.bake_collisions)
+    {
+        // Baked in the scene Collisions, the engine must not add them per tile again
+        for (auto& [tileset_id, source] : obe_scene["Tiles"]["sources"].items())
+        {
+            if (source.contains("collisions"))
+            {
+                source.erase("collisions");
+            }
+        }
+    }
+    if (!args.split_regions.empty())
+    {
+        write_regions(obe_scene, tilesets, args);
+    }
+    else
+    {
+        write_scene(obe_scene, args.output_file, tilesets, args);
+    }
 }
 
 TiledIntegrationArgs parse_args(int argc, char** argv)
 {
     TiledIntegrationArgs args;
 
-    const lyra::cli cli = lyra::arg(args.input_file, "input_file").required(true)
+    // Options come first, positional arguments would accept them otherwise
+    const lyra::cli cli = lyra::opt(args.format, "text|binary")["--format"]("Scene output format")
+                              .choices("text", "binary")
+        | lyra::opt(args.tiles_sidecar)["--tiles-sidecar"](
+            "Write tile grids as raw ids in a .tiles file next to the scene")
+        | lyra::opt(args.tile_encoding, "dense|auto")["--tile-encoding"](
+            "Store each tile layer as dense, run-length or sparse, whichever is smaller")
+              .choices("dense", "auto")
+        | lyra::opt(args.chunk_size, "size")["--chunk-size"](
+            "Split tile layers in chunks of size x size tiles (empty chunks are dropped)")
+        | lyra::opt(args.render_batches)["--render-batches"](
+            "Write per-tileset vertex / uv quads of every layer (or chunk) in a .batches file")
+        | lyra::opt(args.tile_rects)["--tile-rects"](
+            "Add the precomputed texture rect of every tile to the tilesets")
+        | lyra::opt(args.tileset_index)["--tileset-index"](
+            "Add a GID to tileset table and the tilesets used by each layer to the scene")
+        | lyra::opt(args.bake_collisions)["--bake-collisions"](
+            "Merge the collisions of the tiles of every layer into scene colliders")
+        | lyra::opt(args.collision_grid)["--collision-grid"](
+            "Add a bitset of the cells fully covered by tile collisions to the scene")
+        | lyra::opt(args.navigation_cluster_size, "size")["--navigation"](
+            "Add a walkability grid and a pathfinding graph over clusters of size x size "
+            "tiles to the scene")
+        | lyra::opt(args.simplify_tolerance, "pixels")["--simplify-collisions"](
+            "Remove collision polygon points closer than this tolerance to the outline")
+        | lyra::opt(args.convex_collisions)["--convex-collisions"](
+            "Split concave collision polygons in convex parts")
+        | lyra::opt(args.collision_bvh)["--collision-bvh"](
+            "Add the bounding box of every collider and a BVH over them to the scene")
+        | lyra::opt(args.share_collision_shapes)["--share-collision-shapes"](
+            "Write identical collision polygons once and reference them with an offset")
+        | lyra::opt(args.analytic_shapes)["--analytic-shapes"](
+            "Export rectangle and ellipse objects as boxes, circles and capsules")
+        | lyra::opt(args.object_index, "auto|pixels")["--object-index"](
+            "Add a uniform grid of the GameObjects in each cell (cell size in pixels)")
+        | lyra::opt(args.columnar_objects)["--columnar-objects"](
+            "Store GameObjects grouped by type, with an array per field")
+        | lyra::opt(args.split_tile_flags)["--split-tile-flags"](
+            "Store tile flip flags in a packed array next to the tile ids of every layer")
+        | lyra::opt(args.split_regions, "WxH")["--split-regions"](
+            "Write one scene per region of WxH tiles, with a shared tilesets file and an index")
+        | lyra::arg(args.input_file, "input_file").required(true)
         | lyra::arg(args.output_file, "output_file").required(true)
         | lyra::arg(args.cwd, "current_working_directory").required(false);
     const lyra::parse_result result = cli.parse({ argc, argv });
@@ -509,12 +921,20 @@ TiledIntegrationArgs parse_args(int argc, char** argv)
     logger->info("  - Input file : {}", args.input_file);
     logger->info("  - Output file : {}", args.output_file);
     logger->info("  - Current working directory : {}", args.cwd);
+    logger->info("  - Output format : {}", args.format);
 
     if (!result)
     {
         logger->error("Error in command line: {}", result.errorMessage());
         exit(1);
     }
+    if (args.bake_collisions && args.collision_grid)
+    {
+        // Baking removes the tile collisions the grid partial cells refer to
+        logger->error("Error in command line: --bake-collisions and --collision-grid "
+                      "can not be used together");
+        exit(1);
+    }
 
     return args;
 }
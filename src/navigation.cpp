@@ -0,0 +1,332 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <unordered_map>
+
+#include <geometry.hpp>
+#include <navigation.hpp>
+#include <tile_chunks.hpp>
+#include <tile_collisions.hpp>
+
+namespace
+{
+    /**
+     * \brief Entrances narrower than this get a single transition in their middle,
+     *        wider ones a transition at each end
+     */
+    constexpr vili::integer MAX_SINGLE_TRANSITION_WIDTH = 6;
+    constexpr double DIAGONAL_COST = 1.4142135623730951;
+
+    struct WalkGrid
+    {
+        vili::integer width = 0;
+        vili::integer height = 0;
+        std::vector<bool> blocked;
+    };
+
+    /**
+     * \brief Pair of walkable cells on each side of a cluster border
+     */
+    struct Transition
+    {
+        vili::integer inside;
+        vili::integer outside;
+    };
+
+    /**
+     * \brief Blocks the cells of the grid covered by a shape
+     * \param area grid area, in pixels
+     */
+    void rasterize(WalkGrid& grid, const Shape& shape, const Rect& area,
+        double cell_width, double cell_height)
+    {
+        const Rect bounds = shape_bounds(shape);
+        const auto first_x = std::max<vili::integer>(
+            0, static_cast<vili::integer>(std::floor((bounds.x - area.x) / cell_width)));
+        const auto first_y = std::max<vili::integer>(
+            0, static_cast<vili::integer>(std::floor((bounds.y - area.y) / cell_height)));
+        const auto last_x = std::min<vili::integer>(grid.width,
+            static_cast<vili::integer>(
+                std::ceil((bounds.x + bounds.width - area.x) / cell_width)));
+        const auto last_y = std::min<vili::integer>(grid.height,
+            static_cast<vili::integer>(
+                std::ceil((bounds.y + bounds.height - area.y) / cell_height)));
+        for (vili::integer y = first_y; y < last_y; y++)
+        {
+            for (vili::integer x = first_x; x < last_x; x++)
+            {
+                const vili::integer cell = y * grid.width + x;
+                const Rect cell_rect { area.x + x * cell_width, area.y + y * cell_height,
+                    cell_width, cell_height };
+                if (!grid.blocked[cell] && overlaps(shape, cell_rect))
+                {
+                    grid.blocked[cell] = true;
+                }
+            }
+        }
+    }
+
+    /**
+     * \brief Adds the transitions of a cluster border, given as its pairs of
+     *        facing cells in order
+     */
+    void add_transitions(const WalkGrid& grid, const std::vector<Transition>& border,
+        std::vector<Transition>& transitions)
+    {
+        size_t entrance_start = 0;
+        for (size_t index = 0; index <= border.size(); index++)
+        {
+            if (index < border.size() && !grid.blocked[border[index].inside]
+                && !grid.blocked[border[index].outside])
+            {
+                continue;
+            }
+            const auto entrance_width
+                = static_cast<vili::integer>(index - entrance_start);
+            if (entrance_width >= MAX_SINGLE_TRANSITION_WIDTH)
+            {
+                transitions.push_back(border[entrance_start]);
+                transitions.push_back(border[index - 1]);
+            }
+            else if (entrance_width > 0)
+            {
+                transitions.push_back(border[entrance_start + entrance_width / 2]);
+            }
+            entrance_start = index + 1;
+        }
+    }
+
+    /**
+     * \brief Dijkstra from a cell to every cell of its cluster (the rectangle
+     *        [left, right) x [top, bottom)), returns distances indexed by cell in the
+     *        cluster (infinity when unreachable)
+     */
+    std::vector<double> cluster_distances(const WalkGrid& grid, vili::integer start,
+        vili::integer left, vili::integer top, vili::integer right, vili::integer bottom)
+    {
+        const vili::integer width = right - left;
+        const auto local_cell = [&](vili::integer x, vili::integer y)
+        { return (y - top) * width + (x - left); };
+        const auto walkable = [&](vili::integer x, vili::integer y)
+        {
+            return x >= left && x < right && y >= top && y < bottom
+                && !grid.blocked[y * grid.width + x];
+        };
+
+        std::vector<double> distances(
+            width * (bottom - top), std::numeric_limits<double>::infinity());
+        using Visit = std::pair<double, vili::integer>;
+        std::priority_queue<Visit, std::vector<Visit>, std::greater<>> visits;
+        distances[local_cell(start % grid.width, start / grid.width)] = 0;
+        visits.emplace(0, start);
+        while (!visits.empty())
+        {
+            const auto [distance, cell] = visits.top();
+            visits.pop();
+            const vili::integer x = cell % grid.width;
+            const vili::integer y = cell / grid.width;
+            if (distance > distances[local_cell(x, y)])
+            {
+                continue;
+            }
+            for (vili::integer offset_y = -1; offset_y <= 1; offset_y++)
+            {
+                for (vili::integer offset_x = -1; offset_x <= 1; offset_x++)
+                {
+                    const vili::integer next_x = x + offset_x;
+                    const vili::integer next_y = y + offset_y;
+                    if ((!offset_x && !offset_y) || !walkable(next_x, next_y))
+                    {
+                        continue;
+                    }
+                    const bool diagonal = offset_x && offset_y;
+                    if (diagonal && (!walkable(next_x, y) || !walkable(x, next_y)))
+                    {
+                        continue;
+                    }
+                    const double next_distance
+                        = distance + (diagonal ? DIAGONAL_COST : 1);
+                    double& known_distance = distances[local_cell(next_x, next_y)];
+                    if (next_distance < known_distance)
+                    {
+                        known_distance = next_distance;
+                        visits.emplace(next_distance, next_y * grid.width + next_x);
+                    }
+                }
+            }
+        }
+        return distances;
+    }
+}
+
+vili::node make_navigation(const vili::object& scene,
+    const std::vector<Tileset>& tilesets, unsigned int cluster_size, bool tile_collisions)
+{
+    const vili::node& tiles = scene.at("Tiles");
+    const double tile_width = tiles.at("tileWidth").as<vili::integer>();
+    const double tile_height = tiles.at("tileHeight").as<vili::integer>();
+    vili::integer left = 0;
+    vili::integer top = 0;
+    WalkGrid grid;
+    tile_layers_bounds(tiles, left, top, grid.width, grid.height);
+    if (grid.width == 0 || grid.height == 0)
+    {
+        return vili::node {};
+    }
+    grid.blocked.resize(grid.width * grid.height);
+
+    const Rect area { left * tile_width, top * tile_height, grid.width * tile_width,
+        grid.height * tile_height };
+    if (const auto collisions = scene.find("Collisions"); collisions != scene.end())
+    {
+        for (const auto& [collider_id, collider] : collisions->second.items())
+        {
+            rasterize(grid, shape_from_vili(collider), area, tile_width, tile_height);
+        }
+    }
+    if (tile_collisions)
+    {
+        for_each_tile_collision(tiles, tilesets,
+            [&](const TileShape& shape)
+            { rasterize(grid, shape.shape, area, tile_width, tile_height); });
+    }
+
+    const vili::integer size = cluster_size;
+    const vili::integer columns = (grid.width + size - 1) / size;
+    const vili::integer rows = (grid.height + size - 1) / size;
+    std::vector<Transition> transitions;
+    std::vector<Transition> border;
+    for (vili::integer row = 0; row < rows; row++)
+    {
+        for (vili::integer column = 0; column < columns; column++)
+        {
+            const vili::integer right = std::min((column + 1) * size, grid.width);
+            const vili::integer bottom = std::min((row + 1) * size, grid.height);
+            if (right < grid.width)
+            {
+                border.clear();
+                for (vili::integer y = row * size; y < bottom; y++)
+                {
+                    const vili::integer cell = y * grid.width + right - 1;
+                    border.push_back(Transition { cell, cell + 1 });
+                }
+                add_transitions(grid, border, transitions);
+            }
+            if (bottom < grid.height)
+            {
+                border.clear();
+                for (vili::integer x = column * size; x < right; x++)
+                {
+                    const vili::integer cell = (bottom - 1) * grid.width + x;
+                    border.push_back(Transition { cell, cell + grid.width });
+                }
+                add_transitions(grid, border, transitions);
+            }
+        }
+    }
+
+    // Nodes are the transition cells, sorted by cluster then cell
+    const auto cluster_of = [&](vili::integer cell)
+    { return (cell / grid.width / size) * columns + (cell % grid.width) / size; };
+    std::vector<std::pair<vili::integer, vili::integer>> node_cells;
+    node_cells.reserve(transitions.size() * 2);
+    for (const Transition& transition : transitions)
+    {
+        node_cells.emplace_back(cluster_of(transition.inside), transition.inside);
+        node_cells.emplace_back(cluster_of(transition.outside), transition.outside);
+    }
+    std::sort(node_cells.begin(), node_cells.end());
+    node_cells.erase(std::unique(node_cells.begin(), node_cells.end()), node_cells.end());
+    std::unordered_map<vili::integer, uint32_t> cell_nodes;
+    std::vector<vili::integer> cluster_nodes(columns * rows + 1, 0);
+    for (uint32_t node = 0; node < node_cells.size(); node++)
+    {
+        cell_nodes[node_cells[node].second] = node;
+        cluster_nodes[node_cells[node].first + 1]++;
+    }
+    std::partial_sum(cluster_nodes.begin(), cluster_nodes.end(), cluster_nodes.begin());
+
+    std::vector<std::vector<std::pair<uint32_t, double>>> edges(node_cells.size());
+    for (const Transition& transition : transitions)
+    {
+        const uint32_t inside = cell_nodes.at(transition.inside);
+        const uint32_t outside = cell_nodes.at(transition.outside);
+        edges[inside].emplace_back(outside, 1);
+        edges[outside].emplace_back(inside, 1);
+    }
+    for (vili::integer cluster = 0; cluster < columns * rows; cluster++)
+    {
+        const vili::integer cluster_left = (cluster % columns) * size;
+        const vili::integer cluster_top = (cluster / columns) * size;
+        const vili::integer cluster_right = std::min(cluster_left + size, grid.width);
+        const vili::integer cluster_bottom = std::min(cluster_top + size, grid.height);
+        const vili::integer first_node = cluster_nodes[cluster];
+        const vili::integer last_node = cluster_nodes[cluster + 1];
+        for (vili::integer node = first_node; node < last_node; node++)
+        {
+            const std::vector<double> distances
+                = cluster_distances(grid, node_cells[node].second, cluster_left,
+                    cluster_top, cluster_right, cluster_bottom);
+            for (vili::integer target = first_node; target < last_node; target++)
+            {
+                const vili::integer target_x = node_cells[target].second % grid.width;
+                const vili::integer target_y = node_cells[target].second / grid.width;
+                const double distance = distances[(target_y - cluster_top)
+                        * (cluster_right - cluster_left)
+                    + target_x - cluster_left];
+                if (target != node && std::isfinite(distance))
+                {
+                    edges[node].emplace_back(static_cast<uint32_t>(target), distance);
+                }
+            }
+        }
+    }
+
+    std::vector<uint32_t> blocked((grid.blocked.size() + 31) / 32);
+    for (size_t cell = 0; cell < grid.blocked.size(); cell++)
+    {
+        if (grid.blocked[cell])
+        {
+            blocked[cell / 32] |= 1u << (cell % 32);
+        }
+    }
+    vili::array blocked_words;
+    blocked_words.reserve(blocked.size());
+    for (const uint32_t word : blocked)
+    {
+        blocked_words.emplace_back(static_cast<vili::integer>(word));
+    }
+    vili::array clusters;
+    clusters.reserve(cluster_nodes.size());
+    for (const vili::integer cluster_first_node : cluster_nodes)
+    {
+        clusters.emplace_back(cluster_first_node);
+    }
+    vili::array nodes;
+    vili::array node_edges;
+    vili::array edge_targets;
+    vili::array edge_costs;
+    nodes.reserve(node_cells.size());
+    node_edges.reserve(node_cells.size() + 1);
+    for (size_t node = 0; node < node_cells.size(); node++)
+    {
+        nodes.emplace_back(node_cells[node].second);
+        node_edges.emplace_back(static_cast<vili::integer>(edge_targets.size()));
+        std::sort(edges[node].begin(), edges[node].end());
+        for (const auto& [target, cost] : edges[node])
+        {
+            edge_targets.emplace_back(static_cast<vili::integer>(target));
+            edge_costs.emplace_back(cost);
+        }
+    }
+    node_edges.emplace_back(static_cast<vili::integer>(edge_targets.size()));
+
+    return vili::make_object("x", left, "y", top, "width", grid.width, "height",
+        grid.height, "blocked", std::move(blocked_words), "clusterSize", size, "columns",
+        columns, "rows", rows, "clusterNodes", std::move(clusters), "nodes",
+        std::move(nodes), "nodeEdges", std::move(node_edges), "edges",
+        std::move(edge_targets), "costs", std::move(edge_costs));
+}
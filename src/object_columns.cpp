@@ -0,0 +1,121 @@
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <object_columns.hpp>
+
+namespace
+{
+    const std::array<std::string, 5> TRANSFORM_FIELDS
+        = { "x", "y", "width", "height", "rotation" };
+
+    bool is_transform_field(const std::string& key)
+    {
+        for (const std::string& field : TRANSFORM_FIELDS)
+        {
+            if (key == field)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * \brief Objects of a type, properties keep the index (in ids) of each value
+     */
+    struct ObjectGroup
+    {
+        vili::array ids;
+        std::array<vili::array, TRANSFORM_FIELDS.size()> transform;
+        vili::object properties;
+        vili::object property_objects;
+    };
+}
+
+size_t make_object_columns(vili::object& scene)
+{
+    const auto game_objects = scene.find("GameObjects");
+    if (game_objects == scene.end())
+    {
+        return 0;
+    }
+
+    // Types in order of first appearance
+    std::vector<std::string> types;
+    std::vector<ObjectGroup> groups;
+    std::unordered_map<std::string, size_t> type_groups;
+    const vili::node no_requires = vili::object {};
+    for (const auto& [object_id, game_object] : game_objects->second.items())
+    {
+        const std::string& type = game_object.at("type");
+        const auto [type_group, new_type] = type_groups.try_emplace(type, groups.size());
+        if (new_type)
+        {
+            types.push_back(type);
+            groups.emplace_back();
+        }
+        ObjectGroup& group = groups[type_group->second];
+        const auto object_index = static_cast<vili::integer>(group.ids.size());
+        group.ids.emplace_back(object_id);
+
+        const vili::node& object_requires = game_object.contains("Requires")
+            ? game_object.at("Requires")
+            : no_requires;
+        for (size_t field = 0; field < TRANSFORM_FIELDS.size(); field++)
+        {
+            const std::string& key = TRANSFORM_FIELDS[field];
+            const bool has_field = object_requires.contains(key);
+            group.transform[field].push_back(
+                has_field ? object_requires.at(key) : vili::node(0.0));
+        }
+        for (const auto& [key, value] : object_requires.items())
+        {
+            if (is_transform_field(key))
+            {
+                continue;
+            }
+            if (group.properties.find(key) == group.properties.end())
+            {
+                group.properties[key] = vili::array {};
+                group.property_objects[key] = vili::array {};
+            }
+            group.properties[key].push(value);
+            group.property_objects[key].push(object_index);
+        }
+    }
+
+    vili::node columns = vili::object {};
+    for (size_t group_index = 0; group_index < groups.size(); group_index++)
+    {
+        ObjectGroup& group = groups[group_index];
+        vili::node group_columns = vili::make_object("ids", std::move(group.ids));
+        for (size_t field = 0; field < TRANSFORM_FIELDS.size(); field++)
+        {
+            group_columns[TRANSFORM_FIELDS[field]] = std::move(group.transform[field]);
+        }
+        if (!group.properties.empty())
+        {
+            // Properties set on every object of the group need no object list
+            const size_t group_size = group_columns.at("ids").size();
+            vili::node property_objects = vili::object {};
+            for (auto& [key, objects] : group.property_objects)
+            {
+                if (objects.size() != group_size)
+                {
+                    property_objects[key] = std::move(objects);
+                }
+            }
+            group_columns["properties"] = std::move(group.properties);
+            if (!property_objects.empty())
+            {
+                group_columns["propertyObjects"] = std::move(property_objects);
+            }
+        }
+        columns[types[group_index]] = std::move(group_columns);
+    }
+    scene.erase("GameObjects");
+    scene["GameObjectColumns"] = std::move(columns);
+    return groups.size();
+}
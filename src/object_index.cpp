@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include <geometry.hpp>
+#include <object_index.hpp>
+
+namespace
+{
+    /**
+     * \brief Average amount of objects per cell aimed at by the automatic cell size
+     */
+    constexpr double OBJECTS_PER_CELL = 2.0;
+    constexpr double RADIANS_PER_DEGREE = 3.14159265358979323846 / 180;
+
+    /**
+     * \brief Bounds of a GameObject, Tiled rotates objects (clockwise, in degrees)
+     *        around their top-left corner
+     */
+    bool object_bounds(const vili::node& game_object, Rect& bounds)
+    {
+        if (!game_object.contains("Requires"))
+        {
+            return false;
+        }
+        const vili::node& object_requires = game_object.at("Requires");
+        if (!object_requires.contains("x") || !object_requires.contains("y"))
+        {
+            return false;
+        }
+        const auto value = [&object_requires](const std::string& key)
+        {
+            if (!object_requires.contains(key))
+            {
+                return 0.0;
+            }
+            return object_requires.at(key).as<vili::number>();
+        };
+        const double x = value("x");
+        const double y = value("y");
+        const double angle = value("rotation") * RADIANS_PER_DEGREE;
+        const double cos_angle = std::cos(angle);
+        const double sin_angle = std::sin(angle);
+        Polygon corners = to_polygon(Rect { 0, 0, value("width"), value("height") });
+        for (Point& corner : corners)
+        {
+            corner = Point { x + corner.x * cos_angle - corner.y * sin_angle,
+                y + corner.x * sin_angle + corner.y * cos_angle };
+        }
+        bounds = bounding_rect(corners);
+        return true;
+    }
+
+    double automatic_cell_size(const std::vector<Rect>& bounds, const Rect& area)
+    {
+        double extents = 0;
+        for (const Rect& object : bounds)
+        {
+            extents += std::max(object.width, object.height);
+        }
+        // Cells of twice the average object size, grown when objects are sparse
+        const double density_size
+            = std::sqrt(area.width * area.height * OBJECTS_PER_CELL / bounds.size());
+        return std::max({ 1.0, std::ceil(2 * extents / bounds.size()),
+            std::ceil(density_size) });
+    }
+
+    /**
+     * \brief Cells [first, last] overlapped by [start, start + size) on an axis
+     */
+    void cell_range(double start, double size, double cell_size, vili::integer cells,
+        vili::integer& first, vili::integer& last)
+    {
+        const auto clamp_cell = [cells](double index)
+        { return static_cast<vili::integer>(std::clamp(index, 0.0, cells - 1.0)); };
+        first = clamp_cell(std::floor(start / cell_size));
+        last = std::max(first, clamp_cell(std::ceil((start + size) / cell_size) - 1));
+    }
+}
+
+double parse_object_index_cell_size(const std::string& cell_size)
+{
+    if (cell_size == "auto")
+    {
+        return 0;
+    }
+    double size = 0;
+    try
+    {
+        size = std::stod(cell_size);
+    }
+    catch (const std::logic_error&)
+    {
+        size = 0;
+    }
+    if (!(size > 0))
+    {
+        throw std::runtime_error("Invalid object index cell size '" + cell_size
+            + "', expected auto or pixels");
+    }
+    return size;
+}
+
+vili::node make_object_index(const vili::object& scene, double cell_size)
+{
+    const auto game_objects = scene.find("GameObjects");
+    if (game_objects == scene.end())
+    {
+        return vili::node {};
+    }
+    vili::array object_ids;
+    std::vector<Rect> bounds;
+    for (const auto& [object_id, game_object] : game_objects->second.items())
+    {
+        Rect object;
+        if (object_bounds(game_object, object))
+        {
+            object_ids.emplace_back(object_id);
+            bounds.push_back(object);
+        }
+    }
+    if (bounds.empty())
+    {
+        return vili::node {};
+    }
+
+    Rect area = bounds.front();
+    for (const Rect& object : bounds)
+    {
+        area = merge(area, object);
+    }
+    area.width += area.x - std::floor(area.x);
+    area.height += area.y - std::floor(area.y);
+    area.x = std::floor(area.x);
+    area.y = std::floor(area.y);
+    if (cell_size <= 0)
+    {
+        cell_size = automatic_cell_size(bounds, area);
+    }
+    const auto columns = std::max<vili::integer>(
+        1, static_cast<vili::integer>(std::ceil(area.width / cell_size)));
+    const auto rows = std::max<vili::integer>(
+        1, static_cast<vili::integer>(std::ceil(area.height / cell_size)));
+
+    // Objects of each cell, in objects order
+    std::vector<std::vector<vili::integer>> cells(columns * rows);
+    const auto object_count = static_cast<vili::integer>(bounds.size());
+    for (vili::integer index = 0; index < object_count; index++)
+    {
+        const Rect& object = bounds[index];
+        vili::integer left = 0;
+        vili::integer right = 0;
+        vili::integer top = 0;
+        vili::integer bottom = 0;
+        cell_range(object.x - area.x, object.width, cell_size, columns, left, right);
+        cell_range(object.y - area.y, object.height, cell_size, rows, top, bottom);
+        for (vili::integer row = top; row <= bottom; row++)
+        {
+            for (vili::integer column = left; column <= right; column++)
+            {
+                cells[row * columns + column].push_back(index);
+            }
+        }
+    }
+
+    vili::array cell_items;
+    vili::array items;
+    cell_items.reserve(cells.size() + 1);
+    for (const std::vector<vili::integer>& cell : cells)
+    {
+        cell_items.emplace_back(static_cast<vili::integer>(items.size()));
+        items.insert(items.end(), cell.begin(), cell.end());
+    }
+    cell_items.emplace_back(static_cast<vili::integer>(items.size()));
+
+    return vili::make_object("x", coordinate_to_vili(area.x), "y",
+        coordinate_to_vili(area.y), "cellSize", coordinate_to_vili(cell_size), "columns",
+        columns, "rows", rows, "objects", std::move(object_ids), "cells",
+        std::move(cell_items), "items", std::move(items));
+}
@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include <geometry.hpp>
+#include <regions.hpp>
+
+namespace
+{
+    const std::vector<std::string> POSITIONED_SECTIONS = { "Sprites", "Collisions", "GameObjects" };
+
+    /**
+     * \brief Position (in scene pixels) used to pick the region of an element
+     */
+    bool element_anchor(const std::string& section, const vili::node& element, double& x, double& y)
+    {
+        if (section == "Sprites")
+        {
+            x = element.at("rect").at("x");
+            y = element.at("rect").at("y");
+            return true;
+        }
+        if (section == "Collisions" && !element.contains("points"))
+        {
+            const Rect bounds = shape_bounds(shape_from_vili(element));
+            x = bounds.x + bounds.width / 2;
+            y = bounds.y + bounds.height / 2;
+            return true;
+        }
+        if (section == "Collisions")
+        {
+            const vili::node& points = element.at("points");
+            if (points.empty())
+            {
+                return false;
+            }
+            x = 0;
+            y = 0;
+            for (const vili::node& point : points)
+            {
+                x += point.at("x").as<vili::number>();
+                y += point.at("y").as<vili::number>();
+            }
+            x /= points.size();
+            y /= points.size();
+            return true;
+        }
+        if (element.contains("Requires") && element.at("Requires").contains("x")
+            && element.at("Requires").contains("y"))
+        {
+            x = element.at("Requires").at("x");
+            y = element.at("Requires").at("y");
+            return true;
+        }
+        return false;
+    }
+
+    unsigned int region_index(double position, double region_size, unsigned int regions)
+    {
+        const double index = std::floor(position / region_size);
+        return static_cast<unsigned int>(std::clamp(index, 0.0, regions - 1.0));
+    }
+
+    vili::node crop_layer(const vili::node& layer, const Region& region)
+    {
+        const vili::integer layer_x = layer.at("x");
+        const vili::integer layer_y = layer.at("y");
+        const vili::integer layer_width = layer.at("width");
+        const vili::integer layer_height = layer.at("height");
+        const vili::integer left = std::max(region.tile_x, layer_x);
+        const vili::integer top = std::max(region.tile_y, layer_y);
+        const vili::integer right = std::min(region.tile_x + region.width, layer_x + layer_width);
+        const vili::integer bottom
+            = std::min(region.tile_y + region.height, layer_y + layer_height);
+        if (right <= left || bottom <= top)
+        {
+            return vili::node {};
+        }
+
+        const vili::array& tiles = layer.at("tiles").as<vili::array>();
+        vili::array cropped;
+        cropped.reserve((right - left) * (bottom - top));
+        for (vili::integer y = top; y < bottom; y++)
+        {
+            const auto row = tiles.begin() + (y - layer_y) * layer_width;
+            cropped.insert(
+                cropped.end(), row + (left - layer_x), row + (right - layer_x));
+        }
+
+        vili::node region_layer = vili::object {};
+        region_layer.reserve(layer.size());
+        for (const auto& [key, value] : layer.items())
+        {
+            if (key != "tiles")
+            {
+                region_layer[key] = value;
+            }
+        }
+        region_layer["x"] = left;
+        region_layer["y"] = top;
+        region_layer["width"] = right - left;
+        region_layer["height"] = bottom - top;
+        region_layer["tiles"] = std::move(cropped);
+        return region_layer;
+    }
+}
+
+void parse_region_size(const std::string& size, unsigned int& width, unsigned int& height)
+{
+    const size_t separator = size.find('x');
+    try
+    {
+        if (separator == std::string::npos)
+        {
+            throw std::invalid_argument(size);
+        }
+        width = std::stoul(size.substr(0, separator));
+        height = std::stoul(size.substr(separator + 1));
+    }
+    catch (const std::logic_error&)
+    {
+        width = height = 0;
+    }
+    if (!width || !height)
+    {
+        throw std::runtime_error("Invalid region size '" + size + "', expected WxH (in tiles)");
+    }
+}
+
+RegionGrid split_regions(
+    const vili::object& scene, unsigned int region_width, unsigned int region_height)
+{
+    const vili::node& tiles = scene.at("Tiles");
+    const vili::integer map_width = tiles.at("width");
+    const vili::integer map_height = tiles.at("height");
+    const double tile_width = tiles.at("tileWidth").as<vili::integer>();
+    const double tile_height = tiles.at("tileHeight").as<vili::integer>();
+
+    RegionGrid grid;
+    grid.region_width = region_width;
+    grid.region_height = region_height;
+    grid.columns = std::max<unsigned int>(1, (map_width + region_width - 1) / region_width);
+    grid.rows = std::max<unsigned int>(1, (map_height + region_height - 1) / region_height);
+    grid.regions.reserve(grid.columns * grid.rows);
+    for (unsigned int row = 0; row < grid.rows; row++)
+    {
+        for (unsigned int column = 0; column < grid.columns; column++)
+        {
+            Region region;
+            region.id = "x" + std::to_string(column) + "_y" + std::to_string(row);
+            region.column = column;
+            region.row = row;
+            region.tile_x = vili::integer(column) * region_width;
+            region.tile_y = vili::integer(row) * region_height;
+            region.width = std::min<vili::integer>(region_width, map_width - region.tile_x);
+            region.height = std::min<vili::integer>(region_height, map_height - region.tile_y);
+
+            region.scene["Meta"] = scene.at("Meta");
+            region.scene["Meta"]["name"]
+                = scene.at("Meta").at("name").as<vili::string>() + "_" + region.id;
+            region.scene["View"] = scene.at("View");
+            vili::node region_tiles = vili::make_object("tileWidth", tiles.at("tileWidth"),
+                "tileHeight", tiles.at("tileHeight"), "width", region.width, "height",
+                region.height, "layers", vili::object {});
+            for (const auto& [layer_id, layer] : tiles.at("layers").items())
+            {
+                vili::node region_layer = crop_layer(layer, region);
+                if (!region_layer.is_null())
+                {
+                    region_tiles["layers"][layer_id] = std::move(region_layer);
+                }
+            }
+            region.scene["Tiles"] = std::move(region_tiles);
+            grid.regions.push_back(std::move(region));
+        }
+    }
+
+    for (const std::string& section : POSITIONED_SECTIONS)
+    {
+        if (scene.find(section) == scene.end())
+        {
+            continue;
+        }
+        for (const auto& [element_id, element] : scene.at(section).items())
+        {
+            double x = 0;
+            double y = 0;
+            const bool positioned = element_anchor(section, element, x, y);
+            const unsigned int column
+                = positioned ? region_index(x, tile_width * region_width, grid.columns) : 0;
+            const unsigned int row
+                = positioned ? region_index(y, tile_height * region_height, grid.rows) : 0;
+            vili::object& region_scene = grid.regions[row * grid.columns + column].scene;
+            if (region_scene.find(section) == region_scene.end())
+            {
+                region_scene[section] = vili::object {};
+            }
+            region_scene[section][element_id] = element;
+        }
+    }
+    return grid;
+}
+
+vili::node make_regions_index(const RegionGrid& grid, const vili::object& scene,
+    const std::vector<std::string>& region_files, const std::string& tilesets_file)
+{
+    const vili::integer tile_width = scene.at("Tiles").at("tileWidth");
+    const vili::integer tile_height = scene.at("Tiles").at("tileHeight");
+    vili::node items = vili::object {};
+    items.reserve(grid.regions.size());
+    for (size_t index = 0; index < grid.regions.size(); index++)
+    {
+        const Region& region = grid.regions[index];
+        vili::node neighbors = vili::array {};
+        for (int offset_y = -1; offset_y <= 1; offset_y++)
+        {
+            for (int offset_x = -1; offset_x <= 1; offset_x++)
+            {
+                const int column = static_cast<int>(region.column) + offset_x;
+                const int row = static_cast<int>(region.row) + offset_y;
+                if ((offset_x || offset_y) && column >= 0 && row >= 0
+                    && column < static_cast<int>(grid.columns)
+                    && row < static_cast<int>(grid.rows))
+                {
+                    neighbors.push(grid.regions[row * grid.columns + column].id);
+                }
+            }
+        }
+        items[region.id] = vili::make_object("file", region_files[index], "bounds",
+            vili::make_object("x", region.tile_x * tile_width, "y",
+                region.tile_y * tile_height, "width", region.width * tile_width, "height",
+                region.height * tile_height, "unit", "ScenePixels"),
+            "neighbors", std::move(neighbors));
+    }
+    return vili::make_object("scene", scene.at("Meta").at("name"), "regionWidth",
+        vili::integer(grid.region_width), "regionHeight", vili::integer(grid.region_height),
+        "columns", vili::integer(grid.columns), "rows", vili::integer(grid.rows), "tilesets",
+        tilesets_file, "items", std::move(items));
+}
@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <array>
+#include <utility>
+
+#include <logger.hpp>
+#include <render_batches.hpp>
+#include <sidecar.hpp>
+#include <tile_chunks.hpp>
+
+namespace
+{
+    struct Batch
+    {
+        vili::node* owner;
+        std::string texture_id;
+        std::string vertices;
+    };
+
+    void append_quad(std::string& vertices, const Tileset& tileset, uint32_t gid,
+        float x, float y, uint32_t map_tile_height)
+    {
+        const TileRect rect
+            = tileset.tile_rect((gid & ~TILE_FLAGS_MASK) - tileset.first_tile_id);
+        // A diagonal flip transposes the tile, its quad too
+        const bool diagonal = gid & FLIPPED_DIAGONALLY_FLAG;
+        const uint32_t quad_width = diagonal ? rect.height : rect.width;
+        const uint32_t quad_height = diagonal ? rect.width : rect.height;
+        const float left = x;
+        const float right = x + static_cast<float>(quad_width);
+        const float bottom = y + static_cast<float>(map_tile_height);
+        const float top = bottom - static_cast<float>(quad_height);
+
+        // Texture corners in quad order : top-left, top-right, bottom-right, bottom-left
+        std::array<std::pair<float, float>, 4> uvs = { {
+            { static_cast<float>(rect.x), static_cast<float>(rect.y) },
+            { static_cast<float>(rect.x + rect.width), static_cast<float>(rect.y) },
+            { static_cast<float>(rect.x + rect.width),
+                static_cast<float>(rect.y + rect.height) },
+            { static_cast<float>(rect.x), static_cast<float>(rect.y + rect.height) },
+        } };
+        // Diagonal flip (transposition) is applied first, like in Tiled
+        if (diagonal)
+        {
+            std::swap(uvs[1], uvs[3]);
+        }
+        if (gid & FLIPPED_HORIZONTALLY_FLAG)
+        {
+            std::swap(uvs[0], uvs[1]);
+            std::swap(uvs[2], uvs[3]);
+        }
+        if (gid & FLIPPED_VERTICALLY_FLAG)
+        {
+            std::swap(uvs[0], uvs[3]);
+            std::swap(uvs[1], uvs[2]);
+        }
+
+        const std::array<std::pair<float, float>, 4> positions
+            = { { { left, top }, { right, top }, { right, bottom }, { left, bottom } } };
+        for (size_t corner = 0; corner < positions.size(); corner++)
+        {
+            append_float(vertices, positions[corner].first);
+            append_float(vertices, positions[corner].second);
+            append_float(vertices, uvs[corner].first);
+            append_float(vertices, uvs[corner].second);
+        }
+    }
+}
+
+void write_render_batches(vili::node& tiles, const std::vector<Tileset>& tilesets,
+    const std::string& sidecar_path, const std::string& sidecar_reference)
+{
+    const uint32_t tile_width = tiles.at("tileWidth").as<vili::integer>();
+    const uint32_t tile_height = tiles.at("tileHeight").as<vili::integer>();
+
+    // Every texture gets a slot, collections get one slot per image
+    std::vector<size_t> first_slots;
+    std::vector<std::string> slot_ids;
+    for (const Tileset& tileset : tilesets)
+    {
+        first_slots.push_back(slot_ids.size());
+        if (tileset.is_collection())
+        {
+            const int32_t images
+                = *std::max_element(tileset.images.begin(), tileset.images.end()) + 1;
+            for (int32_t image = 0; image < images; image++)
+            {
+                slot_ids.push_back(tileset.id + "_" + std::to_string(image));
+            }
+        }
+        else
+        {
+            slot_ids.push_back(tileset.id);
+        }
+    }
+
+    std::vector<Batch> batches;
+    for_each_tile_grid(tiles,
+        [&](const TileGrid& grid)
+        {
+            if (!grid.tiles.is<vili::array>())
+            {
+                return;
+            }
+            // Grid batches, in textures order
+            std::vector<std::string> grid_vertices(slot_ids.size());
+            const vili::array& tile_ids = grid.tiles.as<vili::array>();
+            for (size_t index = 0; index < tile_ids.size(); index++)
+            {
+                const auto gid = static_cast<uint32_t>(tile_ids[index].as<vili::integer>());
+                const Tileset* tileset = find_tileset(tilesets, gid);
+                if (tileset == nullptr)
+                {
+                    continue;
+                }
+                const auto column = static_cast<vili::integer>(index) % grid.width;
+                const auto row = static_cast<vili::integer>(index) / grid.width;
+                size_t slot = first_slots[tileset - tilesets.data()];
+                if (tileset->is_collection())
+                {
+                    slot += tileset->images[(gid & ~TILE_FLAGS_MASK) - tileset->first_tile_id];
+                }
+                append_quad(grid_vertices[slot], *tileset, gid,
+                    static_cast<float>((grid.x + column) * tile_width),
+                    static_cast<float>((grid.y + row) * tile_height), tile_height);
+            }
+            for (size_t slot = 0; slot < slot_ids.size(); slot++)
+            {
+                if (!grid_vertices[slot].empty())
+                {
+                    batches.push_back(
+                        Batch { &grid.owner, slot_ids[slot], std::move(grid_vertices[slot]) });
+                }
+            }
+        });
+
+    SidecarWriter sidecar(RENDER_BATCHES_MAGIC, RENDER_BATCHES_VERSION, batches.size());
+    size_t quads = 0;
+    for (const Batch& batch : batches)
+    {
+        vili::node& owner_batches = (*batch.owner)["batches"];
+        if (owner_batches.is_null())
+        {
+            owner_batches = vili::object {};
+        }
+        owner_batches[batch.texture_id] = sidecar.add_block(
+            batch.vertices, RENDER_BATCHES_VERTEX_SIZE, sidecar_reference);
+        quads += batch.vertices.size() / (4 * RENDER_BATCHES_VERTEX_SIZE);
+    }
+
+    sidecar.write(sidecar_path);
+    logger->info("  - Render batches : {} ({} batches, {} quads, {} bytes)", sidecar_path,
+        batches.size(), quads, sidecar.size());
+}
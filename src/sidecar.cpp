@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <sidecar.hpp>
+
+namespace
+{
+    constexpr size_t HEADER_SIZE = 16;
+    constexpr size_t DIRECTORY_ENTRY_SIZE = 24;
+    constexpr size_t BLOCK_ALIGNMENT = 8;
+
+    void write_little_endian(std::string& output, size_t position, uint64_t value, size_t size)
+    {
+        for (size_t byte = 0; byte < size; byte++)
+        {
+            output[position + byte] = static_cast<char>((value >> (byte * 8)) & 0xFF);
+        }
+    }
+}
+
+void append_little_endian(std::string& output, uint64_t value, size_t size)
+{
+    for (size_t byte = 0; byte < size; byte++)
+    {
+        output.push_back(static_cast<char>((value >> (byte * 8)) & 0xFF));
+    }
+}
+
+void append_float(std::string& output, float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    append_little_endian(output, bits, sizeof(bits));
+}
+
+SidecarWriter::SidecarWriter(const char (&magic)[4], uint32_t version, size_t blocks)
+    : m_blocks(blocks)
+{
+    m_data.resize(HEADER_SIZE + blocks * DIRECTORY_ENTRY_SIZE);
+    std::copy(std::begin(magic), std::end(magic), m_data.begin());
+    write_little_endian(m_data, 4, version, 4);
+    write_little_endian(m_data, 8, blocks, 4);
+}
+
+vili::node SidecarWriter::add_block(
+    const std::string& block, uint32_t element_size, const std::string& reference)
+{
+    if (m_next_block == m_blocks)
+    {
+        throw std::runtime_error("Sidecar directory is full");
+    }
+    m_data.resize((m_data.size() + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT * BLOCK_ALIGNMENT);
+    const size_t offset = m_data.size();
+    m_data.append(block);
+
+    const size_t entry = HEADER_SIZE + m_next_block++ * DIRECTORY_ENTRY_SIZE;
+    write_little_endian(m_data, entry, offset, 8);
+    write_little_endian(m_data, entry + 8, block.size(), 8);
+    write_little_endian(m_data, entry + 16, element_size, 4);
+    return vili::make_object("file", reference, "offset", static_cast<vili::integer>(offset),
+        "length", static_cast<vili::integer>(block.size()), "elementSize",
+        static_cast<vili::integer>(element_size));
+}
+
+size_t SidecarWriter::size() const
+{
+    return m_data.size();
+}
+
+void SidecarWriter::write(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::out | std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Could not open sidecar file " + path);
+    }
+    file.write(m_data.data(), m_data.size());
+}
@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <limits>
+
+#include <tile_chunks.hpp>
+
+void chunk_tile_layers(vili::node& tiles, unsigned int chunk_size)
+{
+    for (auto& [layer_id, layer] : tiles.at("layers").items())
+    {
+        if (!layer.contains("tiles") || !layer.at("tiles").is<vili::array>())
+        {
+            continue;
+        }
+        const vili::array grid = std::move(layer.at("tiles").as<vili::array>());
+        const vili::integer width = layer.at("width");
+        const vili::integer height = layer.at("height");
+
+        vili::node items = vili::object {};
+        vili::integer min_x = std::numeric_limits<vili::integer>::max();
+        vili::integer min_y = min_x;
+        vili::integer max_x = -1;
+        vili::integer max_y = -1;
+        for (vili::integer chunk_y = 0; chunk_y * chunk_size < height; chunk_y++)
+        {
+            for (vili::integer chunk_x = 0; chunk_x * chunk_size < width; chunk_x++)
+            {
+                const vili::integer left = chunk_x * chunk_size;
+                const vili::integer top = chunk_y * chunk_size;
+                const vili::integer chunk_width = std::min<vili::integer>(chunk_size, width - left);
+                const vili::integer chunk_height
+                    = std::min<vili::integer>(chunk_size, height - top);
+                vili::array chunk_tiles;
+                chunk_tiles.reserve(chunk_width * chunk_height);
+                bool empty = true;
+                for (vili::integer y = top; y < top + chunk_height; y++)
+                {
+                    for (vili::integer x = left; x < left + chunk_width; x++)
+                    {
+                        const vili::node& tile = grid[y * width + x];
+                        empty = empty && tile.as<vili::integer>() == 0;
+                        chunk_tiles.push_back(tile);
+                    }
+                }
+                if (empty)
+                {
+                    continue;
+                }
+                min_x = std::min(min_x, chunk_x);
+                min_y = std::min(min_y, chunk_y);
+                max_x = std::max(max_x, chunk_x);
+                max_y = std::max(max_y, chunk_y);
+                items["x" + std::to_string(chunk_x) + "_y" + std::to_string(chunk_y)]
+                    = vili::make_object("x", chunk_x, "y", chunk_y, "width", chunk_width,
+                        "height", chunk_height, "tiles", std::move(chunk_tiles));
+            }
+        }
+
+        vili::node bounds = (max_x < 0)
+            ? vili::make_object("x", 0, "y", 0, "width", 0, "height", 0)
+            : vili::make_object("x", min_x, "y", min_y, "width", max_x - min_x + 1,
+                "height", max_y - min_y + 1);
+        layer.erase("tiles");
+        layer["chunks"] = vili::make_object("width", vili::integer(chunk_size), "height",
+            vili::integer(chunk_size), "bounds", std::move(bounds), "items", std::move(items));
+    }
+}
+
+void tile_layers_bounds(const vili::node& tiles, vili::integer& x, vili::integer& y,
+    vili::integer& width, vili::integer& height)
+{
+    vili::integer right = 0;
+    vili::integer bottom = 0;
+    bool first_layer = true;
+    x = y = 0;
+    for (const auto& [layer_id, layer] : tiles.at("layers").items())
+    {
+        const vili::integer layer_x = layer.at("x");
+        const vili::integer layer_y = layer.at("y");
+        x = first_layer ? layer_x : std::min(x, layer_x);
+        y = first_layer ? layer_y : std::min(y, layer_y);
+        right = std::max(right, layer_x + layer.at("width").as<vili::integer>());
+        bottom = std::max(bottom, layer_y + layer.at("height").as<vili::integer>());
+        first_layer = false;
+    }
+    width = std::max<vili::integer>(0, right - x);
+    height = std::max<vili::integer>(0, bottom - y);
+}
+
+void for_each_tile_grid(
+    vili::node& tiles, const std::function<void(const TileGrid& grid)>& callback)
+{
+    for (auto& [layer_id, layer] : tiles.at("layers").items())
+    {
+        const vili::integer layer_x = layer.at("x");
+        const vili::integer layer_y = layer.at("y");
+        if (layer.contains("tiles"))
+        {
+            callback(TileGrid { layer_id, layer, layer.at("tiles"), layer_x, layer_y,
+                layer.at("width") });
+        }
+        else if (layer.contains("chunks"))
+        {
+            vili::node& chunks = layer.at("chunks");
+            const vili::integer chunk_width = chunks.at("width");
+            const vili::integer chunk_height = chunks.at("height");
+            for (auto& [chunk_id, chunk] : chunks.at("items").items())
+            {
+                callback(TileGrid { layer_id, chunk, chunk.at("tiles"),
+                    layer_x + chunk.at("x").as<vili::integer>() * chunk_width,
+                    layer_y + chunk.at("y").as<vili::integer>() * chunk_height,
+                    chunk.at("width") });
+            }
+        }
+    }
+}
@@ -0,0 +1,266 @@
+#include <algorithm>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+#include <geometry.hpp>
+#include <tile_chunks.hpp>
+#include <tile_collisions.hpp>
+
+namespace
+{
+    vili::node make_collider(const Shape& shape, const std::string& tag)
+    {
+        vili::node collider = vili::object {};
+        shape_to_vili(shape, collider);
+        collider["unit"] = "ScenePixels";
+        if (!tag.empty())
+        {
+            collider["tag"] = tag;
+        }
+        return collider;
+    }
+
+    /**
+     * \brief Collisions of a tile with its flips applied
+     */
+    struct FlippedTile
+    {
+        std::vector<TileShape> shapes;
+        double image_height = 0;
+    };
+
+    FlippedTile flip_tile(const Tileset& tileset, uint32_t local_id, uint32_t gid)
+    {
+        const TileRect& image = tileset.tile_rect(local_id);
+        const bool horizontal = gid & FLIPPED_HORIZONTALLY_FLAG;
+        const bool vertical = gid & FLIPPED_VERTICALLY_FLAG;
+        const bool diagonal = gid & FLIPPED_DIAGONALLY_FLAG;
+        FlippedTile tile;
+        tile.image_height = diagonal ? image.width : image.height;
+        tile.shapes.reserve(tileset.collisions[local_id].size());
+        for (const TileShape& shape : tileset.collisions[local_id])
+        {
+            const Shape flipped = flip_shape(
+                shape.shape, image.width, image.height, horizontal, vertical, diagonal);
+            tile.shapes.push_back(TileShape { flipped, shape.tag });
+        }
+        return tile;
+    }
+
+    /**
+     * \brief Returns true if the (flipped) collisions of a tile cover its whole cell
+     */
+    bool covers_cell(const FlippedTile& tile, double tile_width, double tile_height)
+    {
+        std::vector<Rect> rects;
+        for (const TileShape& shape : tile.shapes)
+        {
+            Rect rect;
+            if (as_rect(shape.shape, rect))
+            {
+                rects.push_back(rect);
+            }
+        }
+        // Shapes are relative to the tile image, which is bottom-aligned on the cell
+        const double image_top = tile_height - tile.image_height;
+        double covered_area = 0;
+        for (const Rect& rect : merge_rects(rects))
+        {
+            const double left = std::max(rect.x, 0.0);
+            const double right = std::min(rect.x + rect.width, tile_width);
+            const double top = std::max(rect.y + image_top, 0.0);
+            const double bottom = std::min(rect.y + image_top + rect.height, tile_height);
+            if (right > left && bottom > top)
+            {
+                covered_area += (right - left) * (bottom - top);
+            }
+        }
+        return covered_area >= tile_width * tile_height;
+    }
+}
+
+void for_each_tile_collision(const vili::node& tiles,
+    const std::vector<Tileset>& tilesets,
+    const std::function<void(const TileShape& shape)>& callback)
+{
+    const double tile_width = tiles.at("tileWidth").as<vili::integer>();
+    const double tile_height = tiles.at("tileHeight").as<vili::integer>();
+
+    // Flipped collisions, computed once per GID (tile id and flags)
+    std::unordered_map<uint32_t, FlippedTile> flipped_tiles;
+    for (const auto& [layer_id, layer] : tiles.at("layers").items())
+    {
+        const vili::integer layer_x = layer.at("x");
+        const vili::integer layer_y = layer.at("y");
+        const vili::integer layer_width = layer.at("width");
+        const vili::array& tile_ids = layer.at("tiles").as<vili::array>();
+        for (size_t index = 0; index < tile_ids.size(); index++)
+        {
+            const auto gid = static_cast<uint32_t>(tile_ids[index].as<vili::integer>());
+            const Tileset* tileset = find_tileset(tilesets, gid);
+            if (tileset == nullptr)
+            {
+                continue;
+            }
+            const uint32_t local_id = (gid & ~TILE_FLAGS_MASK) - tileset->first_tile_id;
+            if (tileset->collisions[local_id].empty())
+            {
+                continue;
+            }
+            auto flipped_tile = flipped_tiles.find(gid);
+            if (flipped_tile == flipped_tiles.end())
+            {
+                flipped_tile = flipped_tiles
+                                   .emplace(gid, flip_tile(*tileset, local_id, gid))
+                                   .first;
+            }
+            // Tile images are bottom-aligned on their cell
+            const auto column = layer_x + static_cast<vili::integer>(index) % layer_width;
+            const auto row = layer_y + static_cast<vili::integer>(index) / layer_width;
+            const double x = column * tile_width;
+            const double y = (row + 1) * tile_height - flipped_tile->second.image_height;
+            for (const TileShape& shape : flipped_tile->second.shapes)
+            {
+                callback(TileShape { translate(shape.shape, x, y), shape.tag });
+            }
+        }
+    }
+}
+
+CollisionBakingStats bake_tile_collisions(
+    vili::object& scene, const std::vector<Tileset>& tilesets)
+{
+    CollisionBakingStats stats;
+    std::map<std::string, std::vector<Rect>> rects;
+    std::vector<TileShape> shapes;
+    for_each_tile_collision(scene.at("Tiles"), tilesets,
+        [&](const TileShape& shape)
+        {
+            Rect rect;
+            if (as_rect(shape.shape, rect))
+            {
+                rects[shape.tag].push_back(rect);
+            }
+            else
+            {
+                shapes.push_back(shape);
+            }
+            stats.tile_shapes++;
+        });
+
+    if (rects.empty() && shapes.empty())
+    {
+        return stats;
+    }
+    if (scene.find("Collisions") == scene.end())
+    {
+        scene["Collisions"] = vili::object {};
+    }
+    vili::node& collisions = scene["Collisions"];
+    const auto add_collider = [&](const Shape& shape, const std::string& tag)
+    {
+        collisions["tile_collider_" + std::to_string(stats.colliders++)]
+            = make_collider(shape, tag);
+    };
+    for (const auto& [tag, tag_rects] : rects)
+    {
+        for (const Rect& rect : merge_rects(tag_rects))
+        {
+            Shape shape;
+            shape.points = to_polygon(rect);
+            add_collider(shape, tag);
+        }
+    }
+    for (const TileShape& shape : shapes)
+    {
+        add_collider(shape.shape, shape.tag);
+    }
+    return stats;
+}
+
+vili::node make_collision_grid(const vili::node& tiles, const std::vector<Tileset>& tilesets)
+{
+    const double tile_width = tiles.at("tileWidth").as<vili::integer>();
+    const double tile_height = tiles.at("tileHeight").as<vili::integer>();
+
+    // Whether each GID (tile id and flags) is solid, flips move the shapes of tiles
+    // bigger than a cell in or out of it
+    std::unordered_map<uint32_t, bool> solid_tiles;
+
+    const vili::node& layers = tiles.at("layers");
+    vili::integer left = 0;
+    vili::integer top = 0;
+    vili::integer width = 0;
+    vili::integer height = 0;
+    tile_layers_bounds(tiles, left, top, width, height);
+
+    std::vector<uint32_t> solid((width * height + 31) / 32);
+    std::vector<std::pair<vili::integer, uint32_t>> partial;
+    for (const auto& [layer_id, layer] : layers.items())
+    {
+        const vili::integer layer_x = layer.at("x");
+        const vili::integer layer_y = layer.at("y");
+        const vili::integer layer_width = layer.at("width");
+        const vili::array& tile_ids = layer.at("tiles").as<vili::array>();
+        for (size_t index = 0; index < tile_ids.size(); index++)
+        {
+            const auto gid = static_cast<uint32_t>(tile_ids[index].as<vili::integer>());
+            const Tileset* tileset = find_tileset(tilesets, gid);
+            if (tileset == nullptr)
+            {
+                continue;
+            }
+            const uint32_t local_id = (gid & ~TILE_FLAGS_MASK) - tileset->first_tile_id;
+            if (tileset->collisions[local_id].empty())
+            {
+                continue;
+            }
+            const vili::integer x = layer_x + static_cast<vili::integer>(index) % layer_width;
+            const vili::integer y = layer_y + static_cast<vili::integer>(index) / layer_width;
+            const vili::integer cell = (y - top) * width + (x - left);
+            auto solid_tile = solid_tiles.find(gid);
+            if (solid_tile == solid_tiles.end())
+            {
+                const FlippedTile tile = flip_tile(*tileset, local_id, gid);
+                solid_tile = solid_tiles
+                                 .emplace(gid, covers_cell(tile, tile_width, tile_height))
+                                 .first;
+            }
+            if (solid_tile->second)
+            {
+                solid[cell / 32] |= 1u << (cell % 32);
+            }
+            else
+            {
+                partial.emplace_back(cell, gid);
+            }
+        }
+    }
+
+    // Partial shapes of solid cells are redundant
+    partial.erase(std::remove_if(partial.begin(), partial.end(),
+                      [&solid](const std::pair<vili::integer, uint32_t>& reference)
+                      {
+                          return solid[reference.first / 32] & (1u << (reference.first % 32));
+                      }),
+        partial.end());
+    std::stable_sort(partial.begin(), partial.end(),
+        [](const auto& left, const auto& right) { return left.first < right.first; });
+
+    vili::array solid_words;
+    solid_words.reserve(solid.size());
+    for (const uint32_t word : solid)
+    {
+        solid_words.emplace_back(static_cast<vili::integer>(word));
+    }
+    vili::array partial_cells;
+    partial_cells.reserve(partial.size() * 2);
+    for (const auto& [cell, gid] : partial)
+    {
+        partial_cells.emplace_back(cell);
+        partial_cells.emplace_back(static_cast<vili::integer>(gid));
+    }
+    return vili::make_object("x", left, "y", top, "width", width, "height", height, "solid",
+        std::move(solid_words), "partial", std::move(partial_cells));
+}
@@ -0,0 +1,223 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+
+#include <tile_chunks.hpp>
+#include <tile_encoding.hpp>
+#include <tilesets.hpp>
+
+namespace
+{
+    size_t varint_size(uint64_t value)
+    {
+        size_t size = 1;
+        while (value >= 0x80)
+        {
+            value >>= 7;
+            size++;
+        }
+        return size;
+    }
+
+    double tiles_entropy(const vili::array& tiles)
+    {
+        std::unordered_map<vili::integer, size_t> histogram;
+        for (const vili::node& tile : tiles)
+        {
+            histogram[tile.as<vili::integer>()]++;
+        }
+        double entropy = 0;
+        for (const auto& [tile, count] : histogram)
+        {
+            const double probability = static_cast<double>(count) / tiles.size();
+            entropy -= probability * std::log2(probability);
+        }
+        return entropy;
+    }
+
+    vili::node encode_run_length(const vili::array& tiles)
+    {
+        vili::node runs = vili::array {};
+        for (size_t index = 0; index < tiles.size();)
+        {
+            const vili::integer tile = tiles[index].as<vili::integer>();
+            size_t end = index + 1;
+            while (end < tiles.size() && tiles[end].as<vili::integer>() == tile)
+            {
+                end++;
+            }
+            runs.push(vili::integer(end - index));
+            runs.push(tile);
+            index = end;
+        }
+        return vili::make_object("encoding", "rle", "size", vili::integer(tiles.size()),
+            "runs", std::move(runs));
+    }
+
+    vili::node encode_sparse(const vili::array& tiles)
+    {
+        vili::array mask((tiles.size() + 31) / 32, vili::integer(0));
+        vili::node values = vili::array {};
+        for (size_t index = 0; index < tiles.size(); index++)
+        {
+            const vili::integer tile = tiles[index].as<vili::integer>();
+            if (tile != 0)
+            {
+                vili::node& word = mask[index / 32];
+                word = word.as<vili::integer>() | (vili::integer(1) << (index % 32));
+                values.push(tile);
+            }
+        }
+        return vili::make_object("encoding", "sparse", "size", vili::integer(tiles.size()),
+            "mask", std::move(mask), "values", std::move(values));
+    }
+
+    size_t integers_size(const vili::array& integers)
+    {
+        size_t size = 0;
+        for (const vili::node& value : integers)
+        {
+            size += varint_size(static_cast<uint64_t>(value.as<vili::integer>()));
+        }
+        return size;
+    }
+}
+
+std::string to_string(TileEncoding encoding)
+{
+    switch (encoding)
+    {
+    case TileEncoding::RunLength:
+        return "rle";
+    case TileEncoding::Sparse:
+        return "sparse";
+    default:
+        return "dense";
+    }
+}
+
+EncodedTiles encode_tiles(vili::array tiles)
+{
+    EncodedTiles result;
+    result.entropy = tiles_entropy(tiles);
+    result.dense_size = integers_size(tiles);
+    result.encoded_size = result.dense_size;
+
+    vili::node run_length = encode_run_length(tiles);
+    const size_t run_length_size = integers_size(run_length.at("runs").as<vili::array>());
+    vili::node sparse = encode_sparse(tiles);
+    const size_t sparse_size = integers_size(sparse.at("mask").as<vili::array>())
+        + integers_size(sparse.at("values").as<vili::array>());
+
+    if (run_length_size < result.encoded_size && run_length_size <= sparse_size)
+    {
+        result.encoding = TileEncoding::RunLength;
+        result.encoded_size = run_length_size;
+        result.tiles = std::move(run_length);
+    }
+    else if (sparse_size < result.encoded_size)
+    {
+        result.encoding = TileEncoding::Sparse;
+        result.encoded_size = sparse_size;
+        result.tiles = std::move(sparse);
+    }
+    else
+    {
+        result.tiles = std::move(tiles);
+    }
+    return result;
+}
+
+std::string to_string(const TileLayerStats& stats)
+{
+    std::string description;
+    size_t grids_amount = 0;
+    for (const size_t grids : stats.grids)
+    {
+        grids_amount += grids;
+    }
+    for (const TileEncoding encoding :
+        { TileEncoding::Dense, TileEncoding::RunLength, TileEncoding::Sparse })
+    {
+        const size_t grids = stats.grids[static_cast<size_t>(encoding)];
+        if (grids == grids_amount)
+        {
+            return to_string(encoding);
+        }
+        if (grids)
+        {
+            description += (description.empty() ? "" : ", ") + std::to_string(grids) + " "
+                + to_string(encoding);
+        }
+    }
+    return description;
+}
+
+std::vector<TileLayerStats> encode_tile_layers(vili::node& tiles)
+{
+    std::vector<TileLayerStats> stats;
+    for_each_tile_grid(tiles,
+        [&stats](const TileGrid& grid)
+        {
+            if (!grid.tiles.is<vili::array>())
+            {
+                return;
+            }
+            if (stats.empty() || stats.back().layer_id != grid.layer_id)
+            {
+                stats.push_back(TileLayerStats { grid.layer_id });
+            }
+            TileLayerStats& layer = stats.back();
+            const size_t grid_tiles = grid.tiles.size();
+            EncodedTiles encoded = encode_tiles(std::move(grid.tiles.as<vili::array>()));
+            grid.tiles = std::move(encoded.tiles);
+            layer.grids[static_cast<size_t>(encoded.encoding)]++;
+            layer.dense_size += encoded.dense_size;
+            layer.encoded_size += encoded.encoded_size;
+            layer.entropy = (layer.entropy * layer.tiles + encoded.entropy * grid_tiles)
+                / std::max<size_t>(layer.tiles + grid_tiles, 1);
+            layer.tiles += grid_tiles;
+        });
+    return stats;
+}
+
+size_t split_tile_flags(vili::node& tiles)
+{
+    size_t flipped_tiles = 0;
+    for_each_tile_grid(tiles,
+        [&flipped_tiles](const TileGrid& grid)
+        {
+            if (!grid.tiles.is<vili::array>())
+            {
+                return;
+            }
+            vili::array& tile_ids = grid.tiles.as<vili::array>();
+            std::vector<uint32_t> flags((tile_ids.size() + 7) / 8);
+            bool has_flags = false;
+            for (size_t index = 0; index < tile_ids.size(); index++)
+            {
+                const auto gid
+                    = static_cast<uint32_t>(tile_ids[index].as<vili::integer>());
+                const uint32_t tile_flags = (gid & TILE_FLAGS_MASK) >> 28;
+                if (tile_flags)
+                {
+                    flags[index / 8] |= tile_flags << (4 * (index % 8));
+                    tile_ids[index] = static_cast<vili::integer>(gid & ~TILE_FLAGS_MASK);
+                    has_flags = true;
+                    flipped_tiles++;
+                }
+            }
+            if (has_flags)
+            {
+                vili::array packed_flags;
+                packed_flags.reserve(flags.size());
+                for (const uint32_t word : flags)
+                {
+                    packed_flags.emplace_back(static_cast<vili::integer>(word));
+                }
+                grid.owner["flags"] = std::move(packed_flags);
+            }
+        });
+    return flipped_tiles;
+}
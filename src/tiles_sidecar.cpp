@@ -0,0 +1,49 @@
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include <logger.hpp>
+#include <sidecar.hpp>
+#include <tile_chunks.hpp>
+#include <tiles_sidecar.hpp>
+
+void write_tiles_sidecar(
+    vili::node& tiles, const std::string& sidecar_path, const std::string& sidecar_reference)
+{
+    std::vector<vili::node*> grids;
+    for_each_tile_grid(tiles,
+        [&grids](const TileGrid& grid)
+        {
+            if (grid.tiles.is<vili::array>())
+            {
+                grids.push_back(&grid.tiles);
+            }
+        });
+
+    SidecarWriter sidecar(TILES_SIDECAR_MAGIC, TILES_SIDECAR_VERSION, grids.size());
+    std::string block;
+    for (vili::node* grid : grids)
+    {
+        const vili::array& tile_ids = grid->as<vili::array>();
+        const bool fits_uint16 = std::all_of(tile_ids.begin(), tile_ids.end(),
+            [](const vili::node& tile) { return tile.as<vili::integer>() <= 0xFFFF; });
+        const uint32_t element_size = fits_uint16 ? 2 : 4;
+
+        block.clear();
+        block.reserve(tile_ids.size() * element_size);
+        for (const vili::node& tile : tile_ids)
+        {
+            const vili::integer tile_id = tile.as<vili::integer>();
+            if (tile_id < 0 || tile_id > 0xFFFFFFFF)
+            {
+                throw std::runtime_error("Tile id does not fit in 32 bits");
+            }
+            append_little_endian(block, static_cast<uint64_t>(tile_id), element_size);
+        }
+        *grid = sidecar.add_block(block, element_size, sidecar_reference);
+    }
+
+    sidecar.write(sidecar_path);
+    logger->info("  - Tiles sidecar : {} ({} blocks, {} bytes)", sidecar_path,
+        grids.size(), sidecar.size());
+}
@@ -0,0 +1,254 @@
+#include <algorithm>
+
+#include <tilesets.hpp>
+
+bool Tileset::is_collection() const
+{
+    return !images.empty();
+}
+
+const TileRect& Tileset::tile_rect(uint32_t local_id) const
+{
+    return rects.at(local_id);
+}
+
+namespace
+{
+    void compute_atlas_rects(Tileset& tileset)
+    {
+        const uint32_t columns = std::max(1u, tileset.columns);
+        tileset.rects.reserve(tileset.tile_count);
+        for (uint32_t local_id = 0; local_id < tileset.tile_count; local_id++)
+        {
+            const uint32_t column = local_id % columns;
+            const uint32_t row = local_id / columns;
+            tileset.rects.push_back(
+                TileRect { tileset.margin + column * (tileset.tile_width + tileset.spacing),
+                    tileset.margin + row * (tileset.tile_height + tileset.spacing),
+                    tileset.tile_width, tileset.tile_height });
+        }
+    }
+
+    void compute_collection_rects(Tileset& tileset, const vili::node& images)
+    {
+        // Tile ids of collections can have gaps (removed tiles)
+        vili::integer last_id = -1;
+        for (const vili::node& image : images)
+        {
+            last_id = std::max(last_id, image.at("id").as<vili::integer>());
+        }
+        tileset.rects.resize(last_id + 1);
+        tileset.images.resize(last_id + 1, -1);
+        for (size_t index = 0; index < images.size(); index++)
+        {
+            const vili::node& image = images.at(index);
+            const vili::integer local_id = image.at("id").as<vili::integer>();
+            tileset.rects[local_id] = TileRect { 0, 0,
+                static_cast<uint32_t>(image.at("width").as<vili::integer>()),
+                static_cast<uint32_t>(image.at("height").as<vili::integer>()) };
+            tileset.images[local_id] = static_cast<int32_t>(index);
+        }
+    }
+}
+
+std::vector<Tileset> load_tilesets(const vili::node& sources)
+{
+    std::vector<Tileset> tilesets;
+    tilesets.reserve(sources.size());
+    for (const auto& [tileset_id, source] : sources.items())
+    {
+        Tileset tileset;
+        tileset.id = tileset_id;
+        tileset.first_tile_id = source.at("firstTileId").as<vili::integer>();
+        tileset.tile_count = source.at("tilecount").as<vili::integer>();
+        tileset.columns = source.at("columns").as<vili::integer>();
+        tileset.margin = source.at("margin").as<vili::integer>();
+        tileset.spacing = source.at("spacing").as<vili::integer>();
+        tileset.tile_width = source.at("tile").at("width").as<vili::integer>();
+        tileset.tile_height = source.at("tile").at("height").as<vili::integer>();
+        if (source.contains("images"))
+        {
+            compute_collection_rects(tileset, source.at("images"));
+        }
+        else
+        {
+            compute_atlas_rects(tileset);
+        }
+        tileset.collisions.resize(tileset.rects.size());
+        if (source.contains("collisions"))
+        {
+            for (const vili::node& collision : source.at("collisions"))
+            {
+                const vili::integer local_id = collision.at("id").as<vili::integer>();
+                if (local_id < 0
+                    || local_id >= static_cast<vili::integer>(tileset.rects.size()))
+                {
+                    continue;
+                }
+                tileset.collisions[local_id].push_back(TileShape {
+                    shape_from_vili(collision),
+                    collision.contains("tag") ? collision.at("tag").as<vili::string>() : "" });
+            }
+        }
+        tilesets.push_back(std::move(tileset));
+    }
+    std::sort(tilesets.begin(), tilesets.end(),
+        [](const Tileset& left, const Tileset& right)
+        { return left.first_tile_id < right.first_tile_id; });
+    return tilesets;
+}
+
+const Tileset* find_tileset(const std::vector<Tileset>& tilesets, uint32_t gid)
+{
+    const uint32_t tile_id = gid & ~TILE_FLAGS_MASK;
+    const auto next = std::upper_bound(tilesets.begin(), tilesets.end(), tile_id,
+        [](uint32_t id, const Tileset& tileset) { return id < tileset.first_tile_id; });
+    if (tile_id == 0 || next == tilesets.begin())
+    {
+        return nullptr;
+    }
+    const Tileset& tileset = *(next - 1);
+    const uint32_t local_id = tile_id - tileset.first_tile_id;
+    if (local_id >= tileset.rects.size()
+        || (tileset.is_collection() && tileset.images[local_id] < 0))
+    {
+        return nullptr;
+    }
+    return &tileset;
+}
+
+void add_tile_rect_tables(vili::node& sources, const std::vector<Tileset>& tilesets)
+{
+    for (const Tileset& tileset : tilesets)
+    {
+        vili::node& source = sources.at(tileset.id);
+        vili::array rects;
+        rects.reserve(tileset.rects.size() * 4);
+        for (const TileRect& rect : tileset.rects)
+        {
+            rects.emplace_back(static_cast<vili::integer>(rect.x));
+            rects.emplace_back(static_cast<vili::integer>(rect.y));
+            rects.emplace_back(static_cast<vili::integer>(rect.width));
+            rects.emplace_back(static_cast<vili::integer>(rect.height));
+        }
+        source["tileRects"] = std::move(rects);
+        if (tileset.is_collection())
+        {
+            vili::array images;
+            images.reserve(tileset.images.size());
+            for (const int32_t image : tileset.images)
+            {
+                images.emplace_back(static_cast<vili::integer>(image));
+            }
+            source["tileImages"] = std::move(images);
+        }
+    }
+}
+
+std::vector<int32_t> make_tile_sources(const std::vector<Tileset>& tilesets)
+{
+    size_t end = 0;
+    for (const Tileset& tileset : tilesets)
+    {
+        end = std::max<size_t>(end, tileset.first_tile_id + tileset.rects.size());
+    }
+    // Tilesets are sorted, overlapping ranges resolve like find_tileset
+    std::vector<int32_t> tile_sources(end, -1);
+    for (size_t index = 0; index < tilesets.size(); index++)
+    {
+        const Tileset& tileset = tilesets[index];
+        for (uint32_t local_id = 0; local_id < tileset.rects.size(); local_id++)
+        {
+            if (!tileset.is_collection() || tileset.images[local_id] >= 0)
+            {
+                tile_sources[tileset.first_tile_id + local_id] = static_cast<int32_t>(index);
+            }
+        }
+    }
+    return tile_sources;
+}
+
+vili::node make_source_index(const std::vector<Tileset>& tilesets)
+{
+    vili::array sources;
+    for (const Tileset& tileset : tilesets)
+    {
+        sources.emplace_back(tileset.id);
+    }
+    vili::array tiles;
+    const std::vector<int32_t> tile_sources = make_tile_sources(tilesets);
+    tiles.reserve(tile_sources.size());
+    for (const int32_t source : tile_sources)
+    {
+        tiles.emplace_back(static_cast<vili::integer>(source));
+    }
+    return vili::make_object("sources", std::move(sources), "tiles", std::move(tiles));
+}
+
+void add_tileset_usage(vili::node& tiles, const std::vector<Tileset>& tilesets)
+{
+    const std::vector<int32_t> tile_sources = make_tile_sources(tilesets);
+    std::vector<bool> scene_usage(tilesets.size());
+    std::vector<uint32_t> tile_ids;
+    std::vector<uint32_t> histogram;
+    for (auto& [layer_id, layer] : tiles.at("layers").items())
+    {
+        const vili::array& layer_tiles = layer.at("tiles").as<vili::array>();
+        // Flat copy of the ids first so the min / max and histogram passes run over
+        // a plain uint32 buffer, GIDs outside of the table count as empty tiles
+        tile_ids.resize(layer_tiles.size());
+        for (size_t index = 0; index < layer_tiles.size(); index++)
+        {
+            const auto tile_id
+                = static_cast<uint32_t>(layer_tiles[index].as<vili::integer>())
+                & ~TILE_FLAGS_MASK;
+            tile_ids[index] = (tile_id < tile_sources.size()) ? tile_id : 0;
+        }
+        uint32_t min_id = UINT32_MAX;
+        uint32_t max_id = 0;
+        for (const uint32_t tile_id : tile_ids)
+        {
+            min_id = std::min(min_id, tile_id);
+            max_id = std::max(max_id, tile_id);
+        }
+
+        vili::array layer_sources;
+        if (!tile_ids.empty())
+        {
+            histogram.assign(max_id - min_id + 1, 0);
+            for (const uint32_t tile_id : tile_ids)
+            {
+                histogram[tile_id - min_id]++;
+            }
+            std::vector<bool> layer_usage(tilesets.size());
+            for (uint32_t offset = 0; offset < histogram.size(); offset++)
+            {
+                const int32_t source = tile_sources.empty() ? -1
+                                                            : tile_sources[min_id + offset];
+                if (histogram[offset] && source >= 0)
+                {
+                    layer_usage[source] = true;
+                }
+            }
+            for (size_t source = 0; source < tilesets.size(); source++)
+            {
+                if (layer_usage[source])
+                {
+                    layer_sources.emplace_back(tilesets[source].id);
+                    scene_usage[source] = true;
+                }
+            }
+        }
+        layer["sources"] = std::move(layer_sources);
+    }
+
+    vili::array used_sources;
+    for (size_t source = 0; source < tilesets.size(); source++)
+    {
+        if (scene_usage[source])
+        {
+            used_sources.emplace_back(tilesets[source].id);
+        }
+    }
+    tiles["usedSources"] = std::move(used_sources);
+}